@@ -14,6 +14,8 @@ def tracks_from_file(tr_file, tr_ttree='event',
     tr_columns = step_vals
     print(f'uproot.open : {tr_file} . . . ')
     T = uproot.open(tr_file)
+    if 'event_code;1' in T.keys():
+        return coded_tracks_from_file(T, step_vals)
     if ('event;1' in T.keys()) == False:
         return 0
     ttree = uproot.open(tr_file)[tr_ttree]
@@ -30,6 +32,28 @@ def tracks_from_file(tr_file, tr_ttree='event',
 
     return dt
 
+def coded_tracks_from_file(T, step_vals):
+    # /output/encoding code: integer columns plus per-file dictionaries.
+    # The particle stays a PDG code, in the ptype column.
+    dt = T['event_code'].arrays(library='pd')
+    processes = T['processes'].arrays(library='pd')
+    tags = T['tags'].arrays(library='pd')
+    process_names = dict(zip(processes['id'], processes['name']))
+    tag_names = dict(zip(tags['id'], tags['name']))
+    dt['creatprosName'] = dt['creatprosID'].map(process_names)
+    dt['endprosName'] = dt['endprosID'].map(process_names)
+    dt['tag'] = dt['tagID'].map(tag_names)
+    dt['ptype'] = dt['pdg']
+    return dt[step_vals].reset_index(drop=True)
+
+def weights_from_file(tr_file):
+    # Statistical weight of every step (/Runmodel/bias/), 1 without biasing
+    T = uproot.open(tr_file)
+    ttree = T['event_code'] if 'event_code;1' in T.keys() else T['event']
+    if 'weight' not in ttree.keys():
+        return 1.
+    return ttree['weight'].array(library='np')
+
 def main():
     parser = argparse.ArgumentParser(description="Script to read tracks from MC output.")
     parser.add_argument('--InputFile', dest='input_file',
@@ -54,6 +78,7 @@ def main():
     for i in range(1,len(df)):
         if (df.loc[i].ptype == df.loc[i-1].ptype) & (df.loc[i].eventID == df.loc[i-1].eventID) &(df.loc[i].trackID == df.loc[i-1].trackID) &(df.loc[i].tag == df.loc[i-1].tag):
             df.loc[i,'step'] = df.loc[i-1,'step'] + 1
+    df.loc[:, 'weight'] = weights_from_file(args.input_file)
     """
     all_emit = 2000
     #duty_cicle_array = np.logspace(2,3.8,50)
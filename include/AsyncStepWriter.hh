@@ -0,0 +1,79 @@
+/// \file AsyncStepWriter.hh
+/// \brief Definition of the AsyncStepWriter class
+
+#ifndef AsyncStepWriter_h
+#define AsyncStepWriter_h 1
+
+#include "globals.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+/// Writes binary step files (see StepRecord.hh) on a dedicated I/O thread.
+///
+/// Every simulation thread packs its finished events into its own chunk;
+/// a full chunk is queued for the I/O thread and the producer carries on
+/// with a free one. There are two chunks per producer (double buffering),
+/// so a producer only blocks when the disk cannot keep up with it.
+/// Open/Close are called by the master, Reserve/Flush by the producers.
+
+class AsyncStepWriter
+{
+  public:
+    static AsyncStepWriter* Instance();
+
+    void Open(const G4String& fileName, G4int nProducers,
+              const std::vector<char>& fileHeader);
+    void Close();
+    G4bool IsOpen() const { return fFile != 0; }
+    /// Whether fileName was opened earlier in this job; Open refuses it
+    G4bool HasWritten(const G4String& fileName) const
+    { return fWrittenFiles.count(fileName) > 0; }
+
+    /// Room for nBytes at the end of the calling thread's chunk. Records
+    /// reserved together always end up in the same frame.
+    char* Reserve(std::size_t nBytes);
+    /// Queue the calling thread's partial chunk (end of its run)
+    void Flush();
+
+    G4double GetBytesWritten() const { return G4double(fBytesWritten.load()); }
+    /// Whether a write failed: the file ends at GetBytesWritten()
+    G4bool HasFailed() const { return fFailed.load(); }
+
+  private:
+    AsyncStepWriter();
+    ~AsyncStepWriter();
+
+    std::vector<char>* AcquireFreeChunk();
+    void Submit(std::vector<char>* chunk);
+    void WriteLoop();
+    G4bool Write(const void* data, std::size_t nBytes);
+    void Fail(const char* what);
+
+    static const std::size_t kChunkSize = 4 * 1024 * 1024;
+
+    std::FILE* fFile;
+    std::set<G4String> fWrittenFiles;
+    std::thread fThread;
+    std::mutex fMutex;
+    std::condition_variable fFreeCondition;
+    std::condition_variable fFullCondition;
+    std::vector<std::vector<char>*> fAllChunks;
+    std::deque<std::vector<char>*> fFreeChunks;
+    std::deque<std::vector<char>*> fFullChunks;
+    G4bool fStopping;
+    std::atomic<unsigned long long> fBytesWritten;
+    std::atomic<G4bool> fFailed;
+
+    static G4ThreadLocal std::vector<char>* fCurrentChunk;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,35 @@
+/// \file BenchDriver.hh
+/// \brief Definition of the BenchDriver class
+
+#ifndef BenchDriver_h
+#define BenchDriver_h 1
+
+#include "G4Timer.hh"
+#include "globals.hh"
+
+/// Throughput benchmark (toyMC --bench, or the toyMC-bench target).
+///
+/// Runs a fixed list of workloads, neutron and gamma point sources with
+/// the NaI and CsI models, with the same number of events each, and
+/// writes one JSON object with the startup time, per workload events/s,
+/// steps/s and output bytes per event, and the peak RSS of the process.
+/// With a fixed base seed (the default in bench mode) every event, and so
+/// every step count, is the same from one build to the next.
+
+class BenchDriver
+{
+  public:
+    // Starts the startup clock: construct it first thing in main()
+    BenchDriver();
+    ~BenchDriver();
+
+    // False if a workload could not be configured
+    G4bool Run(const G4String& metricsFile, G4int nEvents);
+
+  private:
+    G4Timer fStartup;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
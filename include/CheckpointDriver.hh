@@ -0,0 +1,56 @@
+/// \file CheckpointDriver.hh
+/// \brief Definition of the CheckpointDriver class
+
+#ifndef CheckpointDriver_h
+#define CheckpointDriver_h 1
+
+#include "globals.hh"
+
+class CheckpointMessenger;
+
+/// Long runs that survive preemption (/checkpoint/beamOn, /checkpoint/resume).
+///
+/// The run is split into segments of eventsPerSegment events, each a
+/// separate BeamOn writing its own closed file <outputBase>_part<k>.root
+/// (or .steps). After every segment the checkpoint file
+/// <outputBase>.checkpoint is replaced: seed, job, run ID, events done and
+/// the next part. Events are seeded from their IDs (see SeedManager), so
+/// the seeds and the event numbers of the checkpoint are the whole RNG
+/// state: a resumed run draws the same events as an uninterrupted one.
+/// A segment interrupted half way is simulated again on resume, its part
+/// file is overwritten. The parts are merged like shards, e.g. toyMerge.
+///
+/// A resumed job must repeat the configuration commands of the original
+/// macro before /checkpoint/resume.
+
+class CheckpointDriver
+{
+  public:
+    CheckpointDriver();
+    ~CheckpointDriver();
+
+    void BeamOn(G4int nEvents, G4int eventsPerSegment, const G4String& outputBase);
+    void Resume(const G4String& checkpointFile);
+
+  private:
+    struct State {
+      G4String outputBase;
+      G4int nEvents;
+      G4int eventsPerSegment;
+      G4int eventsDone;
+      G4int nextPart;
+      G4int runID;
+      long seed;
+      G4int jobIndex;
+      G4int numJobs;
+    };
+    void RunSegments(State& state);
+    G4bool Write(const State& state) const;
+    G4bool Read(const G4String& fileName, State& state) const;
+
+    CheckpointMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,32 @@
+/// \file CheckpointMessenger.hh
+/// \brief Definition of the CheckpointMessenger class
+
+#ifndef CheckpointMessenger_h
+#define CheckpointMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class CheckpointDriver;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class CheckpointMessenger: public G4UImessenger
+{
+  public:
+  
+    CheckpointMessenger(CheckpointDriver* );
+   ~CheckpointMessenger();
+    void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+  
+    CheckpointDriver*   fDriver;
+    G4UIdirectory*      fCheckpointDir;
+    G4UIcommand*        fBeamOnCmd;
+    G4UIcmdWithAString* fResumeCmd;
+};
+#endif
@@ -11,11 +11,16 @@
 #include "G4Polycone.hh"
 #include <G4Box.hh>
 #include <G4UIcmdWithABool.hh>
+#include <utility>
+#include <vector>
 
 #include "DetectorMessenger.hh"
 
 class G4VPhysicalVolume;
 class G4LogicalVolume;
+class G4UserLimits;
+class G4BOptrForceCollision;
+class ImportanceBiasingOperator;
 
 /// Detector construction class to define materials and geometry.
 
@@ -25,7 +30,27 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     DetectorConstruction();
     virtual ~DetectorConstruction();
     virtual G4VPhysicalVolume* Construct();
+    virtual void ConstructSDandField();
     void ChooseModel(G4String);
+    void AddSensitiveVolume(const G4String& logicalName, const G4String& tag);
+    void ClearSensitiveVolumes();
+    // Off by default; toyMC turns it on for interactive sessions
+    void SetCheckOverlaps(G4bool flag) { fCheckOverlaps = flag; }
+    // GDML file the geometry is read from if it exists, or written to
+    void SetGdmlCache(const G4String& fileName) { fGdmlCache = fileName; }
+    // Implementation of the SS container solid: polycone (default),
+    // multiunion or boolean; the shape is the same
+    void SetContainerSolid(const G4String& style);
+    // Straight-ray navigation timing of the constructed geometry
+    void BenchmarkNavigation(G4int nRays, G4long seed);
+    void AddForcedCollision(const G4String& logicalName);
+    void SetImportance(const G4String& logicalName, G4double importance);
+    void SetRegionCut(const G4String& regionName, const G4String& particle,
+                      G4double cut);
+    void SetRegionLimit(const G4String& regionName, const G4String& limit,
+                        G4double value);
+    // Lengths are in Geant4 units; a change after construction rebuilds
+    // the geometry at the next BeamOn
     void setXehalflength(G4float);
     void setXeradius(G4float);
     void setPb1Thickness(G4float);
@@ -33,6 +58,12 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     void setPb2Thickness(G4float);
 
     void setScintorDistance(G4float);
+    // Scintillator array: nLayers rings of nPhi cubes, built as one
+    // parameterised volume (see ScintorArrayParameterisation)
+    void setScintorNPhi(G4int);
+    void setScintorNLayers(G4int);
+    void setScintorHalfSize(G4float);
+    void setScintorLayerGap(G4float);
     void setConstructFloor(G4bool);
 
     G4float GetXeradius () {return Xeradius;};
@@ -42,6 +73,24 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     G4String RunModel;
   private:
     void DefineMaterial();
+    void GeometryChanged();
+    G4VPhysicalVolume* ReadGdmlCache();
+    void WriteGdmlCache(G4VPhysicalVolume* world);
+    G4String GdmlCacheKey() const;
+    G4bool fCheckOverlaps;
+    G4String fContainerSolid;
+    G4int fScintorNPhi;
+    G4int fScintorNLayers;
+    G4double fScintorHalfSize;
+    G4double fScintorLayerGap;
+    G4bool ScintorArrayFits(G4int nPhi, G4int nLayers, G4double halfSize,
+                            G4double radius, G4double layerGap) const;
+    void ScintorArrayExtent(G4double& innerRadius, G4double& outerRadius,
+                            G4double& halfLength) const;
+    // Switched in place by ChooseModel once constructed
+    G4LogicalVolume* fScintorLV;
+    G4bool fMaterialsDefined;
+    G4String fGdmlCache;
     G4VSolid* CutHolesInSolid(G4VSolid* target_solid, G4double cutter_thickness,G4double hole_radius,G4ThreeVector circle_center,G4int num_holes);
     G4VSolid* SetAnEmptyBox(G4double x1,G4double y1,G4double z1,G4double thickness,G4String name);
     G4VSolid* CreateHexagonalPrism(G4String name, G4double sideLength, G4double height);
@@ -54,6 +103,33 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     void ConstructShapingRing(G4LogicalVolume* motherLV);
     void ConstructHangingRot(G4LogicalVolume* motherLV);
     void ConstructSheild(G4LogicalVolume* motherLV);
+    // Logical volume name and record tag of every sensitive volume
+    std::vector<std::pair<G4String, G4String> > fSensitiveVolumes;
+    // Neutron biasing: forced collisions, and importances for splitting
+    // at volume boundaries (see ImportanceBiasingOperator)
+    std::vector<G4String> fForcedCollisionVolumes;
+    std::vector<std::pair<G4String, G4double> > fImportances;
+    void ConstructBiasing();
+    // Per thread, created once and attached again after a rebuild
+    static G4ThreadLocal G4BOptrForceCollision* fForceCollision;
+    static G4ThreadLocal ImportanceBiasingOperator* fImportance;
+    // Regions around the recorded volumes keep fine production cuts while
+    // the world default is coarse (see PhysicsList::SetCuts); cuts and user
+    // limits per region are set by /Runmodel/region/ and applied again at
+    // every construction
+    struct RegionSettings {
+      G4String name;
+      G4double cuts[4];     // gamma, e-, e+, proton
+      G4double maxStep;     // <= 0: no limit
+      G4double maxTime;
+      G4double minEkin;
+      G4UserLimits* limits;
+    };
+    std::vector<RegionSettings> fRegions;
+    G4bool fRegionsDefined;
+    RegionSettings* FindRegionSettings(const G4String& regionName);
+    void DefineRegions(G4LogicalVolume* targetLV, G4LogicalVolume* scintorLV);
+    void ApplyRegionSettings();
   protected:
     G4LogicalVolume*  fScoringVolume;
     DetectorMessenger* fDetectorMessenger;
@@ -11,6 +11,7 @@ class DetectorConstruction;
 class G4UIcmdWithABool;
 class G4UIcmdWithADouble;
 class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -28,6 +29,35 @@ class DetectorMessenger: public G4UImessenger
     DetectorConstruction*   fDetector;
     G4UIdirectory* fRunparameter;
     G4UIcmdWithAString* fRunModel;
+    G4UIcommand* fAddVolume;
+    G4UIcmdWithoutParameter* fClearVolumes;
+    G4UIcmdWithABool* fCheckOverlaps;
+    G4UIcmdWithAString* fGdmlCache;
+    G4UIcmdWithADoubleAndUnit* fXeRadius;
+    G4UIcmdWithADoubleAndUnit* fXeHalfLength;
+    G4UIcmdWithADoubleAndUnit* fScintorDistance;
+    G4UIcmdWithADoubleAndUnit* fPb1Thickness;
+    G4UIcmdWithADoubleAndUnit* fBPEThickness;
+    G4UIcmdWithADoubleAndUnit* fPb2Thickness;
+    G4UIcmdWithABool* fConstructFloor;
+    G4UIcmdWithAString* fContainerSolid;
+    G4UIcommand* fBenchmarkNavigation;
+    G4UIdirectory* fScintorDir;
+    G4UIcmdWithAnInteger* fScintorNPhi;
+    G4UIcmdWithAnInteger* fScintorNLayers;
+    G4UIcmdWithADoubleAndUnit* fScintorHalfSize;
+    G4UIcmdWithADoubleAndUnit* fScintorLayerGap;
+
+    G4UIcmdWithADoubleAndUnit* NewLengthCommand(const char* path,
+                                                const char* guidance);
+    G4UIcmdWithAnInteger* NewCountCommand(const char* path,
+                                          const char* guidance);
+    G4UIdirectory* fBiasDir;
+    G4UIcmdWithAString* fForceCollision;
+    G4UIcommand* fImportance;
+    G4UIdirectory* fRegionDir;
+    G4UIcommand* fRegionCut;
+    G4UIcommand* fRegionLimit;
 };
 #endif
 
@@ -0,0 +1,47 @@
+/// \file EnergySpectrum.hh
+/// \brief Definition of the EnergySpectrum class
+
+#ifndef EnergySpectrum_h
+#define EnergySpectrum_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+/// Tabulated energy spectrum, sampled in constant time.
+///
+/// The file has two columns, energy (MeV) and relative yield, one point
+/// per line, '#' starting a comment. In "lin" mode the yield is a density
+/// at each point, linear in between (like GPS Arb with Lin); in "hist"
+/// mode the yield of a point is the content of the bin up to the next
+/// point, flat within the bin. The interval is drawn from an alias table
+/// (Walker/Vose), the energy within it by inverting its CDF: two random
+/// numbers per sample, whatever the number of points.
+
+class EnergySpectrum
+{
+  public:
+    EnergySpectrum();
+    ~EnergySpectrum();
+
+    // The table is kept unchanged if the file is not valid
+    G4bool Load(const G4String& fileName, G4bool histogram);
+    void Clear();
+    G4bool IsEmpty() const { return fProbability.empty(); }
+    G4double Sample() const;
+
+  private:
+    void BuildAliasTable(const std::vector<G4double>& weights);
+
+    G4bool fHistogram;
+    std::vector<G4double> fEnergies;
+    std::vector<G4double> fYields;
+    // Interval i is kept with probability fProbability[i], else replaced
+    // by fAlias[i]
+    std::vector<G4double> fProbability;
+    std::vector<G4int> fAlias;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -5,12 +5,59 @@
 #define EventAction_h 1
 
 #include "G4UserEventAction.hh"
+#include "G4ThreeVector.hh"
 #include "globals.hh"
 
+#include <vector>
+
 class RunAction;
+class EventMessenger;
+class StepHit;
+class G4HCofThisEvent;
+class G4Event;
+
+/// What is written for the sensitive volumes: one "event" row per step,
+/// summed "hits" rows per event, or both
+enum RecordMode {
+  kRecordSteps = 1,
+  kRecordHits = 2,
+  kRecordBoth = kRecordSteps | kRecordHits
+};
+
+/// When an event is given up before all its tracks are done, see
+/// StackingAction: never, once the pending energy can no longer reach
+/// the thresholds, or also when the primary did not interact in the Xe
+/// target
+enum EarlyAbortPolicy {
+  kAbortNever = 0,
+  kAbortEnergy,
+  kAbortPrimary
+};
+
+/// Energy deposit summed over the steps of one event in one volume copy,
+/// either per track or for all tracks together
+struct VolumeHit {
+  G4int tag;
+  G4int copyNo;
+  G4int trackID;
+  G4int pdg;
+  G4int nSteps;
+  G4double edep;
+  G4ThreeVector weightedPos;  // sum of dE * step midpoint
+  G4double firstTime;
+  G4double weightedEdep;      // sum of weight * dE
+};
 
 /// Event action class
 ///
+/// Writes the step hits collected by the sensitive detectors at end of
+/// event, as they are and/or summed per volume copy.
+///
+/// With the coincidence trigger on, an event is only written if the Xe
+/// target and at least one scintillator copy are above threshold, the
+/// scintillator deposit starting within the time window after the Xe one.
+/// The early abort policy lets the stacking action drop the remaining
+/// tracks of events that cannot pass anymore.
 
 class EventAction : public G4UserEventAction
 {
@@ -21,12 +68,65 @@ class EventAction : public G4UserEventAction
     virtual void BeginOfEventAction(const G4Event* event);
     virtual void EndOfEventAction(const G4Event* event);
 
+    void SetRecordMode(G4int mode) { fRecordMode = mode; }
+    void SetHitsPerTrack(G4bool flag) { fHitsPerTrack = flag; }
+    void SetTrigger(G4bool flag) { fTriggerEnabled = flag; }
+    void SetXeThreshold(G4double value) { fXeThreshold = value; }
+    void SetScintorThreshold(G4double value) { fScintorThreshold = value; }
+    void SetCoincidenceWindow(G4double value) { fCoincidenceWindow = value; }
+
+    G4bool GetTrigger() const { return fTriggerEnabled; }
+    G4double GetXeThreshold() const { return fXeThreshold; }
+    G4double GetScintorThreshold() const { return fScintorThreshold; }
+    G4double GetCoincidenceWindow() const { return fCoincidenceWindow; }
+
+    void SetEarlyAbort(G4int policy) { fEarlyAbort = policy; }
+    G4int GetEarlyAbort() const { return fTriggerEnabled ? fEarlyAbort
+                                                         : kAbortNever; }
+
+    // Bookkeeping of the current event for the early abort
+    void SetPrimaryInXe() { fPrimaryInXe = true; }
+    G4bool GetPrimaryInXe() const { return fPrimaryInXe; }
+    void SetAbortedEarly() { fAbortedEarly = true; }
+    // Steps of all tracks, summed into the run for the throughput
+    void CountStep() { ++fNSteps; }
+    // Whether the trigger can still pass with pendingEnergy (keV) left to
+    // deposit on top of the hits so far
+    G4bool CanStillTrigger(G4HCofThisEvent* hce, G4double pendingEnergy);
+
   private:
+    // IDs of the RecordSD collections, resolved by name
+    void FindStepCollections(G4int runID);
+    // Trigger and output of the event; nRecords counts the rows written
+    void WriteEvent(const G4Event* event, G4long& nRecords);
+    void SumTriggerDeposits(G4HCofThisEvent* hce);
+    void WarnWeightedTrigger(G4double weight);
+    G4bool PassesTrigger(G4HCofThisEvent* hce);
+    void AddDeposit(const StepHit* step);
+    void FillStepRow(G4int eventID, const StepHit* step);
+    void FillStepCodeRow(G4int eventID, const StepHit* step);
+    void FillStepRecord(char* record, const StepHit* step);
+    void FillHitRows(G4int eventID);
+
     RunAction* fRunAction;
+    EventMessenger* fMessenger;
+    G4int fRecordMode;
+    G4bool fHitsPerTrack;
+    G4bool fTriggerEnabled;
+    G4double fXeThreshold;        // keV
+    G4double fScintorThreshold;   // keV, per copy
+    G4double fCoincidenceWindow;  // ns, <= 0 for no time requirement
+    G4int fEarlyAbort;
+    G4bool fPrimaryInXe;
+    G4bool fAbortedEarly;
+    G4long fNSteps;
+    // Cleared, not freed, between events
+    std::vector<VolumeHit> fHits;
+    std::vector<VolumeHit> fTriggerSums;
+    std::vector<G4int> fStepCollections;
+    G4int fCollectionsRunID;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #endif
-
-    
@@ -0,0 +1,40 @@
+/// \file EventMessenger.hh
+/// \brief Definition of the EventMessenger class
+
+#ifndef EventMessenger_h
+#define EventMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class EventAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class EventMessenger: public G4UImessenger
+{
+  public:
+  
+    EventMessenger(EventAction* );
+   ~EventMessenger();
+    void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+  
+    EventAction*   fEventAction;
+    G4UIdirectory* fRecordDir;
+    G4UIcmdWithAString* fModeCmd;
+    G4UIcmdWithABool* fHitsPerTrackCmd;
+    G4UIdirectory* fTriggerDir;
+    G4UIcmdWithABool* fTriggerCmd;
+    G4UIcmdWithADoubleAndUnit* fXeThresholdCmd;
+    G4UIcmdWithADoubleAndUnit* fScintorThresholdCmd;
+    G4UIcmdWithADoubleAndUnit* fWindowCmd;
+    G4UIcmdWithAString* fEarlyAbortCmd;
+};
+#endif
@@ -0,0 +1,49 @@
+/// \file ImportanceBiasingOperator.hh
+/// \brief Definition of the ImportanceBiasingOperator class
+
+#ifndef ImportanceBiasingOperator_h
+#define ImportanceBiasingOperator_h 1
+
+#include "G4VBiasingOperator.hh"
+
+#include <map>
+
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class SplitOrKillOperation;
+
+/// Biasing operator for the geometry importance splitting, see
+/// SplitOrKillOperation. It must be attached to every volume a biased
+/// track can leave towards a volume of different importance; volumes
+/// without an importance have importance 1.
+
+class ImportanceBiasingOperator : public G4VBiasingOperator
+{
+  public:
+    ImportanceBiasingOperator(const G4String& particleName);
+    virtual ~ImportanceBiasingOperator();
+
+    void SetImportance(const G4LogicalVolume* volume, G4double importance);
+    // Before a geometry rebuild sets them again for the new volumes
+    void ClearImportances() { fImportances.clear(); }
+    G4double GetImportance(const G4LogicalVolume* volume) const;
+
+  private:
+    virtual G4VBiasingOperation*
+    ProposeNonPhysicsBiasingOperation(const G4Track* track,
+                                      const G4BiasingProcessInterface*);
+    virtual G4VBiasingOperation*
+    ProposeOccurenceBiasingOperation(const G4Track*,
+                                     const G4BiasingProcessInterface*) { return 0; }
+    virtual G4VBiasingOperation*
+    ProposeFinalStateBiasingOperation(const G4Track*,
+                                      const G4BiasingProcessInterface*) { return 0; }
+
+    const G4ParticleDefinition* fParticle;
+    SplitOrKillOperation* fSplitOrKill;
+    std::map<const G4LogicalVolume*, G4double> fImportances;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
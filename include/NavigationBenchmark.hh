@@ -0,0 +1,35 @@
+/// \file NavigationBenchmark.hh
+/// \brief Definition of the NavigationBenchmark class
+
+#ifndef NavigationBenchmark_h
+#define NavigationBenchmark_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+class G4VPhysicalVolume;
+
+/// Times the navigation alone: straight rays from random points in a box,
+/// in random directions, are followed boundary to boundary out of the
+/// world with a private G4Navigator. The rays only depend on the seed, so
+/// two geometries (e.g. two solid styles of /Runmodel/containerSolid) are compared
+/// on the same rays.
+
+class NavigationBenchmark
+{
+  public:
+    NavigationBenchmark(G4VPhysicalVolume* world, G4long seed);
+    ~NavigationBenchmark();
+
+    // Prints rays/s, steps/s and the mean steps per ray
+    void Run(G4int nRays, const G4ThreeVector& centre,
+             const G4ThreeVector& halfSize);
+
+  private:
+    G4VPhysicalVolume* fWorld;
+    G4long fSeed;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,51 @@
+/// \file PhaseSpaceFile.hh
+/// \brief Definition of the PhaseSpaceFile class
+
+#ifndef PhaseSpaceFile_h
+#define PhaseSpaceFile_h 1
+
+#include "globals.hh"
+#include "PhaseSpaceRecord.hh"
+
+#include <vector>
+
+/// Read access to a phase-space file written by PhaseSpaceRecorder, by
+/// source event.
+///
+/// A file is indexed once (first record of every source event) and then
+/// shared by all threads: events are read with pread, without a lock, so
+/// that any event can be replayed by any thread in any order.
+
+class PhaseSpaceFile
+{
+  public:
+    /// The shared file of this name, indexed on first use; 0 if it
+    /// cannot be read
+    static const PhaseSpaceFile* Get(const G4String& fileName);
+
+    ~PhaseSpaceFile();
+
+    const G4String& GetFileName() const { return fFileName; }
+    G4int GetNumberOfEvents() const { return G4int(fFirst.size()) - 1; }
+    G4long GetNumberOfRecords() const { return fFirst.back(); }
+    /// Events simulated to record the file, with or without a crossing;
+    /// 0 if unknown
+    G4int GetNumberOfSourceEvents() const { return fNSourceEvents; }
+    /// The records of source event index, 0 <= index < GetNumberOfEvents()
+    void ReadEvent(G4int index, std::vector<PhaseSpaceRecord>& records) const;
+
+  private:
+    PhaseSpaceFile(const G4String& fileName);
+
+    G4bool Index(G4ExceptionDescription& description);
+
+    G4String fFileName;
+    int fDescriptor;
+    G4int fNSourceEvents;
+    // Record number of the first record of every event, then the total
+    std::vector<G4long> fFirst;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,54 @@
+/// \file PhaseSpaceRecord.hh
+/// \brief Layout of the phase-space files written by PhaseSpaceRecorder
+
+#ifndef PhaseSpaceRecord_h
+#define PhaseSpaceRecord_h 1
+
+// Plain C++ on purpose, like StepRecord.hh: the offline tools read these
+// files without Geant4.
+//
+// File layout (little endian):
+//   PhaseSpaceFileHeader
+//   PhaseSpaceRecord until end of file
+// The records of one source event are contiguous, so that the particles
+// leaving the surface together are replayed together.
+
+#include <cstdint>
+
+const char kPhaseSpaceFileMagic[8] = { 'T', 'O', 'Y', 'P', 'H', 'S', 'P', 0 };
+const std::uint32_t kPhaseSpaceFileVersion = 1;
+
+/// The recording surface is a cylinder about the TPC (z) axis, in mm.
+/// Source events without a crossing leave no record, so the number of
+/// simulated events is kept for the normalisation (0: run not finished).
+struct PhaseSpaceFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t recordSize;
+  float radius;
+  float halfLength;
+  float zCentre;
+  std::uint32_t nSourceEvents;
+  std::int64_t seed;
+  std::int32_t jobIndex;
+  std::int32_t numJobs;
+};
+
+/// One particle where it leaves the surface; position in mm, kinetic
+/// energy in MeV, time in ns
+struct PhaseSpaceRecord {
+  std::int32_t eventID;
+  std::int32_t pdg;
+  float position[3];
+  float direction[3];
+  float energy;
+  float time;
+  float weight;
+};
+
+static_assert(sizeof(PhaseSpaceFileHeader) == 48,
+              "PhaseSpaceFileHeader must not be padded");
+static_assert(sizeof(PhaseSpaceRecord) == 44,
+              "PhaseSpaceRecord must not be padded");
+
+#endif
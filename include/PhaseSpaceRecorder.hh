@@ -0,0 +1,85 @@
+/// \file PhaseSpaceRecorder.hh
+/// \brief Definition of the PhaseSpaceRecorder class
+
+#ifndef PhaseSpaceRecorder_h
+#define PhaseSpaceRecorder_h 1
+
+#include "globals.hh"
+#include "G4ThreeVector.hh"
+
+#include <cstdio>
+#include <mutex>
+#include <set>
+#include <vector>
+
+struct PhaseSpaceRecord;
+class G4Step;
+
+/// Records the particles leaving a closed surface into a phase-space file
+/// (see PhaseSpaceRecord.hh), to be replayed with /source/mode phasespace.
+///
+/// The surface is a cylinder about the TPC axis. A track is recorded where
+/// its step crosses the surface outwards and is then killed; secondaries
+/// born outside the surface are killed by the StackingAction, so every
+/// particle reaching the outer geometry is in the file exactly once. The
+/// replay is only equivalent while nothing inside the surface changes.
+///
+/// Every thread collects whole events in its own chunk, appended to the
+/// file under a lock. Open/Close are called by the master, RecordStep,
+/// EndEvent and Flush by the thread doing the tracking. Each run writes
+/// its own file: "auto" names it after the run's output file, so the
+/// segments of /checkpoint/beamOn and the points of /scan/run are kept.
+
+class PhaseSpaceRecorder
+{
+  public:
+    static PhaseSpaceRecorder* Instance();
+
+    // "none": no recording, "auto": <output file>.phsp
+    void SetFileName(const G4String& fileName) { fFileName = fileName; }
+    void SetSurface(G4double radius, G4double halfLength, G4double zCentre);
+
+    /// Whether the current run records, valid from the master's
+    /// BeginOfRunAction on
+    G4bool IsActive() const { return fFile != 0; }
+    G4bool IsInside(const G4ThreeVector& position) const;
+
+    void Open(const G4String& outputFile);
+    /// nSourceEvents: events the run simulated, stored for normalisation
+    void Close(G4int nSourceEvents);
+
+    /// Records the track if this step leaves the surface; returns whether
+    /// it did
+    G4bool RecordStep(const G4Step* step, G4int eventID);
+    /// Writes the calling thread's chunk once it is large, between events
+    void EndEvent();
+    /// Writes the calling thread's chunk (end of its run)
+    void Flush();
+
+  private:
+    PhaseSpaceRecorder();
+    ~PhaseSpaceRecorder();
+
+    void Write(std::vector<PhaseSpaceRecord>* chunk);
+    void Fail(const char* what);
+
+    static const std::size_t kChunkRecords = 16384;
+
+    G4String fFileName;
+    G4String fOpenFile;
+    std::set<G4String> fWrittenFiles;
+    G4double fRadius;
+    G4double fHalfLength;
+    G4double fZCentre;
+
+    std::FILE* fFile;
+    std::mutex fMutex;
+    G4long fNRecords;
+    G4bool fFailed;
+
+    static G4ThreadLocal std::vector<PhaseSpaceRecord>* fChunk;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -4,6 +4,12 @@
 #include "G4VModularPhysicsList.hh"
 #include "globals.hh"
 
+#include <vector>
+
+class G4GenericBiasingPhysics;
+class G4VPhysicsConstructor;
+class PhysicsListMessenger;
+
 class PhysicsList : public G4VModularPhysicsList {
 public:
     PhysicsList();
@@ -14,6 +20,26 @@ public:
     
     // 构建物理过程
     void ConstructProcess() override;
+
+    // 为粒子加上 generic biasing 过程 (/physics/biasing)，只能在 PreInit
+    void EnableBiasing(const G4String& particleName);
+
+    // 物理配置 (/physics/configuration)，只能在 PreInit：
+    // "precision" 为完整的 HP 物理；"fast" 用 EM option1、不要放射性衰变
+    void SetConfiguration(const G4String& name);
+    const G4String& GetConfiguration() const { return fConfiguration; }
+    // 中子 HP 模型的能量上限 (/physics/hpMaxEnergy)，其上用 BIC/CHIPS
+    void SetHPMaxEnergy(G4double energy) { fHPMaxEnergy = energy; }
+
+private:
+    void LimitNeutronHP();
+
+    PhysicsListMessenger* fMessenger;
+    G4String fConfiguration;
+    G4VPhysicsConstructor* fRadioactiveDecay;
+    G4double fHPMaxEnergy;
+    G4GenericBiasingPhysics* fBiasingPhysics;
+    std::vector<G4String> fBiasedParticles;
 };
 
 #endif // PHYSICSLIST_HH
@@ -0,0 +1,34 @@
+/// \file PhysicsListMessenger.hh
+/// \brief Definition of the PhysicsListMessenger class
+
+#ifndef PhysicsListMessenger_h
+#define PhysicsListMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class PhysicsList;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class PhysicsListMessenger: public G4UImessenger
+{
+  public:
+  
+    PhysicsListMessenger(PhysicsList* );
+   ~PhysicsListMessenger();
+    void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+  
+    PhysicsList*   fPhysicsList;
+    G4UIdirectory* fPhysicsDir;
+    G4UIcmdWithAString* fBiasingCmd;
+    G4UIcmdWithAString* fConfigurationCmd;
+    G4UIcmdWithADoubleAndUnit* fHPMaxEnergyCmd;
+};
+#endif
@@ -7,11 +7,39 @@
 #include "G4VUserPrimaryGeneratorAction.hh"
 #include "G4ParticleGun.hh"
 #include "G4GeneralParticleSource.hh"
+#include "G4ThreeVector.hh"
 #include "globals.hh"
 
+#include "EnergySpectrum.hh"
+#include "PhaseSpaceRecord.hh"
+
+#include <vector>
+
 class G4ParticleGun;
 class G4Event;
 class G4Box;
+class PrimaryGeneratorMessenger;
+class PhaseSpaceFile;
+
+/// Where the primaries come from (/source/mode)
+enum SourceMode {
+  kSourceGPS = 0,   // G4GeneralParticleSource, configured with /gps/
+  kSourceNative,    // point source of /source/, see below
+  kSourcePhaseSpace // replay of a phase-space file, see PhaseSpaceRecorder
+};
+
+/// Primary generator action class
+///
+/// By default the primaries come from the GPS. The native source is a
+/// particle gun at a point, isotropic or in a fixed direction, with a mono
+/// energy or a tabulated spectrum (EnergySpectrum) sampled in constant
+/// time; it skips the generic GPS machinery on every event.
+///
+/// The phase-space source replays the particles recorded on a surface
+/// around the inner geometry, all particles of a source event in one
+/// event. Source events are picked by event number, each one used
+/// fRecycle times in a row, optionally turned by a random angle about
+/// the TPC axis.
 
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -22,11 +50,39 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
     // method from the base class
     virtual void GeneratePrimaries(G4Event*);     
     const G4GeneralParticleSource* GetParticleGun() const {return fParticleGun;}
+
+    void SetMode(G4int mode) { fMode = mode; }
+    void SetParticle(const G4String& particleName);
+    void SetPosition(const G4ThreeVector& position) { fPosition = position; }
+    // A null direction means isotropic
+    void SetDirection(const G4ThreeVector& direction);
+    // Mono energy, replaces the spectrum
+    void SetEnergy(G4double energy);
+    void LoadSpectrum(const G4String& fileName, G4bool histogram);
+    // One or more files, separated by blanks
+    void SetPhaseSpaceFiles(const G4String& fileNames);
+    void SetRecycle(G4int nUses) { fRecycle = nUses; }
+    void SetRotate(G4bool flag) { fRotate = flag; }
   
   private:
+    void GeneratePhaseSpace(G4Event* anEvent);
+
     G4GeneralParticleSource*  fParticleGun;
+    PrimaryGeneratorMessenger* fMessenger;
+    G4int fMode;
+    G4ParticleGun* fGun;
+    G4ThreeVector fPosition;
+    G4ThreeVector fDirection;
+    G4double fEnergy;
+    EnergySpectrum fSpectrum;
+    std::vector<const PhaseSpaceFile*> fPhaseSpaces;
+    G4int fNPhaseSpaceEvents;
+    G4int fRecycle;
+    G4bool fRotate;
+    G4bool fWrapped;
+    std::vector<PhaseSpaceRecord> fRecords;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-#endif
\ No newline at end of file
+#endif
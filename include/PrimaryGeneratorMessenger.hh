@@ -0,0 +1,44 @@
+/// \file PrimaryGeneratorMessenger.hh
+/// \brief Definition of the PrimaryGeneratorMessenger class
+
+#ifndef PrimaryGeneratorMessenger_h
+#define PrimaryGeneratorMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class PrimaryGeneratorAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWith3Vector;
+class G4UIcmdWith3VectorAndUnit;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class PrimaryGeneratorMessenger: public G4UImessenger
+{
+  public:
+  
+    PrimaryGeneratorMessenger(PrimaryGeneratorAction* );
+   ~PrimaryGeneratorMessenger();
+    void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+  
+    PrimaryGeneratorAction*    fPrimary;
+    G4UIdirectory*             fSourceDir;
+    G4UIcmdWithAString*        fModeCmd;
+    G4UIcmdWithAString*        fParticleCmd;
+    G4UIcmdWith3VectorAndUnit* fPositionCmd;
+    G4UIcmdWith3Vector*        fDirectionCmd;
+    G4UIcmdWithADoubleAndUnit* fEnergyCmd;
+    G4UIcommand*               fSpectrumCmd;
+    G4UIcmdWithAString*        fPhaseSpaceCmd;
+    G4UIcmdWithAnInteger*      fRecycleCmd;
+    G4UIcmdWithABool*          fRotateCmd;
+};
+#endif
@@ -0,0 +1,59 @@
+/// \file ProcessIDTable.hh
+/// \brief Definition of the ProcessIDTable class
+
+#ifndef ProcessIDTable_h
+#define ProcessIDTable_h 1
+
+#include "globals.hh"
+
+#include <unordered_map>
+#include <vector>
+
+class G4VProcess;
+
+/// Small integer IDs for the processes of the current physics list.
+///
+/// IDs are assigned in alphabetical order of the process names, so every
+/// thread (and every shard using the same physics list) gets the same
+/// numbering. ID 0 is reserved for "unknown" (no process defined the step).
+/// Lookups are a pointer hash, they never allocate. There is one table per
+/// thread, shared by the stepping action and the sensitive detectors.
+
+class ProcessIDTable
+{
+  public:
+    ProcessIDTable();
+    ~ProcessIDTable();
+
+    static ProcessIDTable* Instance();
+
+    /// Rebuild from the process table of the calling thread
+    void Build();
+    /// Rebuild once per run, the physics can only change between runs
+    void UpdateForRun(G4int runID)
+    {
+      if (runID != fRunID) {
+        Build();
+        fRunID = runID;
+      }
+    }
+
+    G4int GetID(const G4VProcess* process) const
+    {
+      if (!process) return 0;
+      auto it = fIDs.find(process);
+      return (it == fIDs.end()) ? 0 : it->second;
+    }
+    G4int FindID(const G4String& name) const;
+    const G4String& GetName(G4int id) const { return fNames[id]; }
+    const std::vector<G4String>& GetNames() const { return fNames; }
+
+  private:
+    std::vector<G4String> fNames;
+    std::unordered_map<const G4VProcess*, G4int> fIDs;
+    G4int fRunID;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,74 @@
+/// \file ProgressReporter.hh
+/// \brief Definition of the ProgressReporter class
+
+#ifndef ProgressReporter_h
+#define ProgressReporter_h 1
+
+#include "globals.hh"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+/// Periodic progress of the current run, for the log and for a status
+/// file that farm monitoring can read instead of the logs.
+///
+/// Every thread counts its finished events, steps and written records in
+/// its own slot. Whichever thread finishes an event once the reporting
+/// interval has passed prints one line with the aggregated events/s,
+/// steps/s, records, binary bytes written, resident memory and ETA, plus
+/// the events/s of each thread, and rewrites the status file (JSON,
+/// replaced atomically). BeginRun/EndRun are called by the master.
+
+class ProgressReporter
+{
+  public:
+    static ProgressReporter* Instance();
+
+    // <= 0 switches the periodic reports off
+    void SetInterval(G4double seconds) { fInterval = seconds; }
+    // "auto": <output file>.status.json, "none": no status file
+    void SetStatusFile(const G4String& fileName) { fStatusFileSetting = fileName; }
+
+    void BeginRun(G4int runID, G4int nEvents, const G4String& outputFile);
+    void EventDone(G4long nSteps, G4long nRecords);
+    void EndRun();
+
+  private:
+    ProgressReporter();
+    ~ProgressReporter();
+
+    typedef std::chrono::steady_clock Clock;
+
+    G4double Seconds(Clock::time_point time) const
+    {
+      return std::chrono::duration<G4double>(time - fStart).count();
+    }
+    void Report(const char* state);
+
+    // Slot of thread i is i % kMaxSlots, so more threads share slots and
+    // their rates are shown together; slot 0 is also the sequential one
+    static const G4int kMaxSlots = 256;
+    struct Slot {
+      std::atomic<G4long> events;
+      std::atomic<G4long> steps;
+      std::atomic<G4long> records;
+      G4long reportedEvents;     // at the previous report
+    };
+    Slot fSlots[kMaxSlots];
+    std::atomic<G4int> fNSlots;
+
+    G4double fInterval;
+    G4String fStatusFileSetting;
+    G4String fStatusFile;
+    G4int fRunID;
+    G4int fNEvents;
+    Clock::time_point fStart;
+    std::atomic<G4double> fNextReport;    // seconds after fStart
+    std::mutex fReportMutex;
+    G4double fLastReport;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,50 @@
+/// \file RecordSD.hh
+/// \brief Definition of the RecordSD class
+
+#ifndef RecordSD_h
+#define RecordSD_h 1
+
+#include "G4VSensitiveDetector.hh"
+#include "StepHit.hh"
+
+class G4Step;
+class G4HCofThisEvent;
+
+/// Tag of a recorded volume, written in the "tag" column
+enum RecordTag {
+  kTagDefault = 0,
+  kTagXe,
+  kTagScintor,
+  kNumRecordTags
+};
+
+/// Sensitive detector recording every step in its volumes as a StepHit.
+///
+/// All instances fill a collection named "steps" and differ only by the
+/// tag written with their hits, so a new recorded volume only needs a
+/// /record/addVolume command.
+
+class RecordSD : public G4VSensitiveDetector
+{
+  public:
+    RecordSD(const G4String& name, G4int tag);
+    virtual ~RecordSD();
+
+    virtual void   Initialize(G4HCofThisEvent* hitCollection);
+    virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory* history);
+
+    G4int GetTag() const { return fTag; }
+
+    static const G4String& GetCollectionName();
+    static const G4String& GetTagName(G4int tag);
+    static G4int FindTag(const G4String& name);
+
+  private:
+    StepHitsCollection* fHitsCollection;
+    G4int fHCID;
+    G4int fTag;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
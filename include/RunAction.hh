@@ -9,6 +9,32 @@
 #include "globals.hh"
 
 class G4Run;
+class RunMessenger;
+
+/// Ntuple IDs, in order of creation in the constructor
+enum {
+  kStepNtuple = 0,
+  kRunInfoNtuple = 1,
+  kHitNtuple = 2,
+  kStepCodeNtuple = 3,
+  kProcessDictNtuple = 4,
+  kTagDictNtuple = 5
+};
+
+/// How the categorical step columns are written: as strings in "event",
+/// or as integer codes in "event_code" with per-file dictionaries
+/// ("processes", "tags"; particles are PDG codes)
+enum OutputEncoding {
+  kEncodeStrings = 0,
+  kEncodeCodes
+};
+
+/// Where the step rows go: the ROOT file, or a binary ".steps" file
+/// written asynchronously by AsyncStepWriter
+enum OutputFormat {
+  kFormatRoot = 0,
+  kFormatBinary
+};
 
 class RunAction : public G4UserRunAction
 {
@@ -22,8 +48,38 @@ class RunAction : public G4UserRunAction
     {
       m_hDataFilename = hFilename;
     }
+    void SetEncoding(G4int encoding) { fEncoding = encoding; }
+    G4int GetEncoding() const { return fEncoding; }
+    void SetFormat(G4int format) { fFormat = format; }
+    G4int GetFormat() const { return fFormat; }
+    // Coincidence trigger decision of one event, see EventAction
+    void CountTrigger(G4bool accepted, G4bool abortedEarly = false)
+    {
+      if (accepted) fAccepted += 1;
+      else fRejected += 1;
+      if (abortedEarly) fAborted += 1;
+    }
+    void CountSteps(G4long nSteps) { fSteps += nSteps; }
+    // Totals of the last run, on the master once it has ended
+    G4long GetNumberOfSteps() const { return fSteps.GetValue(); }
+    G4double GetOutputBytes() const { return fOutputBytes; }
+    /// Name of a file written next to the output file: <outfile>suffix,
+    /// without the ".root" extension of outputFile
+    static G4String SideFileName(const G4String& outputFile,
+                                 const G4String& suffix);
   private:
+    void FillDictionaries(const G4Run* run);
+    void OpenStepFile(const G4Run* run);
+
     G4String m_hDataFilename;
+    RunMessenger* fMessenger;
+    G4int fEncoding;
+    G4int fFormat;
+    G4Accumulable<G4int> fAccepted;
+    G4Accumulable<G4int> fRejected;
+    G4Accumulable<G4int> fAborted;
+    G4Accumulable<G4long> fSteps;
+    G4double fOutputBytes;
 };
 #endif
 
@@ -0,0 +1,38 @@
+/// \file RunMessenger.hh
+/// \brief Definition of the RunMessenger class
+
+#ifndef RunMessenger_h
+#define RunMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class RunAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class RunMessenger: public G4UImessenger
+{
+  public:
+  
+    RunMessenger(RunAction* );
+   ~RunMessenger();
+    void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+  
+    RunAction*   fRunAction;
+    G4UIdirectory* fOutputDir;
+    G4UIcmdWithAString* fEncodingCmd;
+    G4UIcmdWithAString* fFormatCmd;
+    G4UIcmdWithAString* fFileNameCmd;
+    G4UIcmdWithADoubleAndUnit* fProgressIntervalCmd;
+    G4UIcmdWithAString* fStatusFileCmd;
+    G4UIcmdWithAString* fPhaseSpaceCmd;
+    G4UIcommand* fPhaseSpaceSurfaceCmd;
+};
+#endif
@@ -0,0 +1,42 @@
+/// \file ScanDriver.hh
+/// \brief Definition of the ScanDriver class
+
+#ifndef ScanDriver_h
+#define ScanDriver_h 1
+
+#include "globals.hh"
+
+class ScanMessenger;
+
+/// Runs a list of configurations one after the other in this process, so
+/// that materials, physics tables and HP data are loaded once.
+///
+/// Every non-empty line of a scan file is one point: a label, then UI
+/// commands separated by ';'. Settings carry over to the next points.
+///
+///   # label  commands
+///   r7       /Runmodel/setXeradius 7 cm ; /Runmodel/ModelChoose CsI
+///   r8       /Runmodel/setXeradius 8 cm
+///
+/// Each point writes <outputBase>_<label>.root. A point whose commands
+/// fail is skipped.
+
+class ScanDriver
+{
+  public:
+    ScanDriver();
+    ~ScanDriver();
+
+    void Run(const G4String& scanFile, G4int nEvents, const G4String& outputBase);
+
+    /// Applies UI commands separated by ';' up to the first that fails,
+    /// which is reported after the context; returns whether all succeeded
+    static G4bool ApplyCommands(const G4String& commands, const G4String& context);
+
+  private:
+    ScanMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,30 @@
+/// \file ScanMessenger.hh
+/// \brief Definition of the ScanMessenger class
+
+#ifndef ScanMessenger_h
+#define ScanMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class ScanDriver;
+class G4UIdirectory;
+class G4UIcommand;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class ScanMessenger: public G4UImessenger
+{
+  public:
+  
+    ScanMessenger(ScanDriver* );
+   ~ScanMessenger();
+    void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+  
+    ScanDriver*    fScanDriver;
+    G4UIdirectory* fScanDir;
+    G4UIcommand*   fRunCmd;
+};
+#endif
@@ -0,0 +1,39 @@
+/// \file ScintorArrayParameterisation.hh
+/// \brief Definition of the ScintorArrayParameterisation class
+
+#ifndef ScintorArrayParameterisation_h
+#define ScintorArrayParameterisation_h 1
+
+#include "G4VPVParameterisation.hh"
+#include "globals.hh"
+
+class G4VPhysicalVolume;
+
+/// Places the scintillator cubes of one G4PVParameterised on a ring of
+/// layers around the container axis. Copy number = layer*nPhi + phi index,
+/// the numbering of the former individual placements; positions are
+/// relative to the centre of the array envelope. The cubes keep the
+/// orientation of the world axes.
+
+class ScintorArrayParameterisation : public G4VPVParameterisation
+{
+  public:
+    ScintorArrayParameterisation(G4int nPhi, G4int nLayers, G4double radius,
+                                 G4double layerPitch);
+    virtual ~ScintorArrayParameterisation();
+
+    virtual void ComputeTransformation(const G4int copyNo,
+                                       G4VPhysicalVolume* physVol) const;
+
+    G4int GetNumberOfCubes() const { return fNPhi*fNLayers; }
+
+  private:
+    G4int fNPhi;
+    G4int fNLayers;
+    G4double fRadius;
+    G4double fLayerPitch;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
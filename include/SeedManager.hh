@@ -0,0 +1,53 @@
+/// \file SeedManager.hh
+/// \brief Definition of the SeedManager class
+
+#ifndef SeedManager_h
+#define SeedManager_h 1
+
+#include "globals.hh"
+
+/// Reproducible, shardable seeding.
+///
+/// A run is identified by (base seed, job index). The master engine is a
+/// MixMax seeded with both, and every event re-seeds its thread's engine
+/// from (base seed, job index, run ID, event ID), so each event draws from
+/// its own MixMax stream: results do not depend on the number of threads
+/// or on event scheduling, different job indices never share a stream, and
+/// any single shard or event can be reproduced from the stamped values.
+///
+/// A run split into segments (CheckpointDriver) sets the run ID and the
+/// first event ID of the segment: the segments then draw, and write, the
+/// same events as one uninterrupted run would.
+
+class SeedManager
+{
+  public:
+    static void Configure(long baseSeed, G4int jobIndex, G4int numJobs);
+    static void SeedMaster();
+    static void SeedEvent(G4int runID, G4int eventID);
+
+    // Numbering of the segment runs; set by the master between runs
+    static void SetSegment(G4int runID, G4int firstEvent);
+    static void ClearSegment() { SetSegment(-1, 0); }
+    static G4int GetRunID(G4int runID)
+    {
+      return fSegmentRunID < 0 ? runID : fSegmentRunID;
+    }
+    static G4int GetEventID(G4int eventID) { return eventID + fSegmentFirstEvent; }
+
+    static long  GetBaseSeed() { return fBaseSeed; }
+    static G4int GetJobIndex() { return fJobIndex; }
+    static G4int GetNumJobs()  { return fNumJobs; }
+
+  private:
+    // Written once in main() before any worker starts, read-only afterwards
+    static long  fBaseSeed;
+    static G4int fJobIndex;
+    static G4int fNumJobs;
+    static G4int fSegmentRunID;
+    static G4int fSegmentFirstEvent;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
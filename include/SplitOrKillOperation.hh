@@ -0,0 +1,45 @@
+/// \file SplitOrKillOperation.hh
+/// \brief Definition of the SplitOrKillOperation class
+
+#ifndef SplitOrKillOperation_h
+#define SplitOrKillOperation_h 1
+
+#include "G4VBiasingOperation.hh"
+#include "G4ParticleChange.hh"
+
+class ImportanceBiasingOperator;
+
+/// Geometry importance biasing at volume boundaries: a track entering a
+/// volume of higher importance is split into importance ratio copies, one
+/// entering a volume of lower importance plays Russian roulette. The
+/// weights are changed so that every result stays unbiased.
+
+class SplitOrKillOperation : public G4VBiasingOperation
+{
+  public:
+    SplitOrKillOperation(const G4String& name,
+                         const ImportanceBiasingOperator* biasingOperator);
+    virtual ~SplitOrKillOperation();
+
+    // Not a physics biasing
+    virtual const G4VBiasingInteractionLaw*
+    ProvideOccurenceBiasingInteractionLaw(const G4BiasingProcessInterface*,
+                                          G4ForceCondition&) { return 0; }
+    virtual G4VParticleChange*
+    ApplyFinalStateBiasing(const G4BiasingProcessInterface*, const G4Track*,
+                           const G4Step*, G4bool&) { return 0; }
+
+    // Applied after every step, acts on boundary crossings only
+    virtual G4double DistanceToApplyOperation(const G4Track*, G4double,
+                                              G4ForceCondition* condition);
+    virtual G4VParticleChange* GenerateBiasingFinalState(const G4Track* track,
+                                                         const G4Step* step);
+
+  private:
+    const ImportanceBiasingOperator* fOperator;
+    G4ParticleChange fParticleChange;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
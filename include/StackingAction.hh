@@ -0,0 +1,43 @@
+/// \file StackingAction.hh
+/// \brief Definition of the StackingAction class
+
+#ifndef StackingAction_h
+#define StackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "globals.hh"
+
+class EventAction;
+
+/// Stacking action class
+///
+/// With an early abort policy (/record/trigger/earlyAbort), the secondaries
+/// wait until the primaries are done. The event is then given up if the
+/// coincidence trigger can no longer pass: the primary did not interact in
+/// the Xe target (policy "primary"), or the energy the waiting tracks can
+/// still deposit does not reach the thresholds.
+///
+/// While a phase space is recorded, secondaries born outside its surface
+/// are killed: their ancestor has been recorded already.
+
+class StackingAction : public G4UserStackingAction
+{
+  public:
+    StackingAction(EventAction* eventAction);
+    virtual ~StackingAction();
+
+    virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+    virtual void NewStage();
+    virtual void PrepareNewEvent();
+
+  private:
+    EventAction* fEventAction;
+    G4int fStage;
+    G4int fPolicy;              // of the current event
+    G4double fPendingEnergy;    // that the waiting tracks can deposit
+    G4bool fPendingUnbounded;   // a waiting track can release more
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
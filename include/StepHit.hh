@@ -0,0 +1,63 @@
+/// \file StepHit.hh
+/// \brief Definition of the StepHit class
+
+#ifndef StepHit_h
+#define StepHit_h 1
+
+#include "G4VHit.hh"
+#include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+class G4ParticleDefinition;
+
+/// One recorded step in a sensitive volume, i.e. one row of the "event"
+/// ntuple. Energies are in keV, processes are ProcessIDTable IDs, the
+/// weight is the statistical weight of the track (1 without biasing).
+
+class StepHit : public G4VHit
+{
+  public:
+    StepHit();
+    virtual ~StepHit();
+
+    inline void* operator new(size_t);
+    inline void  operator delete(void*);
+
+    const G4ParticleDefinition* fParticle;
+    G4ThreeVector fPrePos;
+    G4ThreeVector fPostPos;
+    G4double fEnergy;
+    G4double fEdep;
+    G4double fTime;
+    G4double fWeight;
+    G4int fTrackID;
+    G4int fParentID;
+    G4int fCreatProcessID;
+    G4int fEndProcessID;
+    G4int fTag;
+    G4int fCopyNo;
+};
+
+typedef G4THitsCollection<StepHit> StepHitsCollection;
+
+extern G4ThreadLocal G4Allocator<StepHit>* StepHitAllocator;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void* StepHit::operator new(size_t)
+{
+  if(!StepHitAllocator)
+      StepHitAllocator = new G4Allocator<StepHit>;
+  return (void *) StepHitAllocator->MallocSingle();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void StepHit::operator delete(void *hit)
+{
+  StepHitAllocator->FreeSingle((StepHit*) hit);
+}
+
+#endif
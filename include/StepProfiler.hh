@@ -0,0 +1,84 @@
+/// \file StepProfiler.hh
+/// \brief Definition of the StepProfiler class
+
+#ifndef StepProfiler_h
+#define StepProfiler_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class G4Step;
+class G4LogicalVolume;
+class G4ParticleDefinition;
+class G4VProcess;
+
+/// Where the transport time goes (/stepping/profile).
+///
+/// Every step is charged the thread CPU time since the previous step of
+/// the track (or since the track started, see TrackingAction), under the
+/// logical volume it was in, the particle and the process that limited
+/// it. Each thread fills its own table, keyed by pointers so a step costs
+/// one hash lookup; at end of run the tables are merged by name and the
+/// master prints them sorted by time, with totals per volume, particle
+/// and process. Reading the clock costs a little on every step, so the
+/// profiler is off by default.
+
+class StepProfiler
+{
+  public:
+    StepProfiler();
+    ~StepProfiler();
+
+    // This thread's profiler
+    static StepProfiler* Instance();
+
+    void SetEnabled(G4bool flag) { fEnabled = flag; }
+    G4bool IsEnabled() const { return fEnabled; }
+
+    void StartTrack() { fLastTime = ThreadTime(); }
+    void CountStep(const G4Step* step);
+
+    // Run bookkeeping: clear this thread's table, add it to the merged
+    // one, and print (then clear) the merged table
+    void Reset() { fTable.clear(); }
+    void Merge();
+    static void Report(G4int maxRows);
+
+  private:
+    static G4double ThreadTime();
+
+    struct Key {
+      const G4LogicalVolume* volume;
+      const G4ParticleDefinition* particle;
+      const G4VProcess* process;
+      bool operator==(const Key& other) const
+      {
+        return volume == other.volume && particle == other.particle &&
+               process == other.process;
+      }
+    };
+    struct KeyHash {
+      std::size_t operator()(const Key& key) const;
+    };
+    struct Entry {
+      G4long steps;
+      G4double seconds;
+    };
+
+    G4bool fEnabled;
+    G4double fLastTime;
+    std::unordered_map<Key, Entry, KeyHash> fTable;
+
+    // Merged tables of all threads, by volume, particle and process name
+    typedef std::map<std::vector<G4String>, Entry> MergedTable;
+    static MergedTable fMerged;
+    static std::mutex fMergeMutex;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
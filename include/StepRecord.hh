@@ -0,0 +1,71 @@
+/// \file StepRecord.hh
+/// \brief Layout of the binary step files written by AsyncStepWriter
+
+#ifndef StepRecord_h
+#define StepRecord_h 1
+
+// Plain C++ on purpose: the offline tools read these files without Geant4.
+//
+// File layout (little endian):
+//   StepFileHeader
+//   StepFileSegment (version 3 on)
+//   u32 nProcesses, then per process: u16 length + name bytes (ID = index)
+//   u32 nTags,      then per tag:     u16 length + name bytes (ID = index)
+//   frames until end of file: u32 payload size + payload
+// A payload is a sequence of whole events:
+//   StepEventHeader followed by nSteps StepRecord
+
+#include <cstdint>
+
+const char kStepFileMagic[8] = { 'T', 'O', 'Y', 'S', 'T', 'E', 'P', 0 };
+// Version 1 had a reserved word where the weight is now, always 0;
+// version 3 added the StepFileSegment
+const std::uint32_t kStepFileVersion = 3;
+
+struct StepFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t recordSize;
+  std::int64_t seed;
+  std::int32_t jobIndex;
+  std::int32_t numJobs;
+};
+
+/// Events of the run in the file: IDs firstEvent to firstEvent + nEvents - 1
+/// of run runID (see SeedManager::SetSegment), as planned at its start
+struct StepFileSegment {
+  std::int32_t runID;
+  std::int32_t firstEvent;
+  std::int32_t nEvents;
+  std::int32_t reserved;
+};
+
+struct StepEventHeader {
+  std::int32_t eventID;
+  std::int32_t nSteps;
+};
+
+/// One row of the "event" ntuple; energies in keV, lengths in mm, time in ns,
+/// statistical weight as a float
+struct StepRecord {
+  double energy;
+  double dE;
+  float pre[3];
+  float post[3];
+  float time;
+  std::int32_t pdg;
+  std::int32_t trackID;
+  std::int32_t parentID;
+  std::int32_t copyNo;
+  std::uint16_t creatProcessID;
+  std::uint16_t endProcessID;
+  std::uint16_t tag;
+  std::uint16_t flags;
+  float weight;
+};
+
+static_assert(sizeof(StepFileHeader) == 32, "StepFileHeader must not be padded");
+static_assert(sizeof(StepFileSegment) == 16, "StepFileSegment must not be padded");
+static_assert(sizeof(StepRecord) == 72, "StepRecord must not be padded");
+
+#endif
@@ -8,11 +8,20 @@
 #include "globals.hh"
 
 class EventAction;
+class SteppingMessenger;
+class StepProfiler;
+class PhaseSpaceRecorder;
 
 class G4LogicalVolume;
 
 /// Stepping action class
-/// 
+///
+/// Recording is done by the sensitive detectors (see RecordSD); this
+/// action only applies the track cuts, using integer process IDs, and
+/// notes primaries interacting in the Xe target for the early abort.
+/// With /stepping/profile on, every step is also charged to the
+/// StepProfiler. While a phase space is recorded, tracks end where they
+/// leave its surface (PhaseSpaceRecorder).
 
 class SteppingAction : public G4UserSteppingAction
 {
@@ -29,12 +38,23 @@ class SteppingAction : public G4UserSteppingAction
     G4bool GetGammaCheck() const { return fGammaCheck; }
     G4bool GetNGplan() const { return fNGplan; }
     G4bool GetOutterSheild() const { return fOutterSheildRecord; }
+
+    void SetKillXeRecoils(G4bool flag) { fKillXeRecoils = flag; }
+    void SetProfile(G4bool flag);
+
   private:
     EventAction*  fEventAction;
     G4LogicalVolume* fScoringVolume;
     G4bool fGammaCheck;
     G4bool fNGplan;
     G4bool fOutterSheildRecord;
+
+    SteppingMessenger* fMessenger;
+    G4int fResolvedRunID;
+    G4int fHadElasticID;
+    G4bool fKillXeRecoils;
+    StepProfiler* fProfiler;
+    PhaseSpaceRecorder* fPhaseSpace;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,32 @@
+/// \file SteppingMessenger.hh
+/// \brief Definition of the SteppingMessenger class
+
+#ifndef SteppingMessenger_h
+#define SteppingMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class SteppingAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class SteppingMessenger: public G4UImessenger
+{
+  public:
+  
+    SteppingMessenger(SteppingAction* );
+   ~SteppingMessenger();
+    void SetNewValue(G4UIcommand*, G4String);
+
+  private:
+  
+    SteppingAction*   fStepping;
+    G4UIdirectory* fSteppingDir;
+    G4UIcmdWithABool* fKillXeCmd;
+    G4UIcmdWithABool* fProfileCmd;
+};
+#endif
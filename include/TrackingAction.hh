@@ -0,0 +1,31 @@
+/// \file TrackingAction.hh
+/// \brief Definition of the TrackingAction class
+
+#ifndef TrackingAction_h
+#define TrackingAction_h 1
+
+#include "G4UserTrackingAction.hh"
+#include "globals.hh"
+
+class StepProfiler;
+
+/// Tracking action class
+///
+/// Starts the clock of the stepping profiler for every track, so the
+/// first step is not charged the time spent between two tracks.
+
+class TrackingAction : public G4UserTrackingAction
+{
+  public:
+    TrackingAction();
+    virtual ~TrackingAction();
+
+    virtual void PreUserTrackingAction(const G4Track*);
+
+  private:
+    StepProfiler* fProfiler;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -1,10 +1,18 @@
 #!/bin/bash
 
+# One multithreaded process per node: the workers share the geometry and the
+# HP neutron data instead of loading them once per process.
 MC_HOME='.'
-for i in $(seq 1 100)
+NTHREADS=${NTHREADS:-$(nproc)}
+NJOBS=${NJOBS:-1}
+# Fixed base seed: shard i is reproducible with the same SEED and job index
+SEED=${SEED:-12345}
+for i in $(seq 1 $NJOBS)
   do
     export Filename='out/'$i
     export Logfile='out/log'$i'.txt'
-    $MC_HOME/build/toyMC marcos/pos.mac $Filename i >$Logfile &
+    $MC_HOME/build/toyMC -t $NTHREADS --seed $SEED \
+      --job-index $((i-1)) --num-jobs $NJOBS marcos/pos.mac $Filename >$Logfile &
     echo "$i" 
   done
+wait
@@ -6,6 +6,8 @@
 #include "RunAction.hh"
 #include "EventAction.hh"
 #include "SteppingAction.hh"
+#include "StackingAction.hh"
+#include "TrackingAction.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -29,6 +31,10 @@ void ActionInitialization::BuildForMaster() const
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+// Called once per worker thread (or once in sequential mode): every action
+// built here is private to its thread, only the settings copied from this
+// object are shared.
+
 void ActionInitialization::Build() const
 {
   SetUserAction(new PrimaryGeneratorAction);
@@ -42,6 +48,10 @@ void ActionInitialization::Build() const
   
   SteppingAction* stepAction = new SteppingAction(eventAction);
   SetUserAction(stepAction);
+
+  SetUserAction(new TrackingAction);
+
+  SetUserAction(new StackingAction(eventAction));
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,208 @@
+/// \file AsyncStepWriter.cc
+/// \brief Implementation of the AsyncStepWriter class
+
+#include "AsyncStepWriter.hh"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+G4ThreadLocal std::vector<char>* AsyncStepWriter::fCurrentChunk = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncStepWriter* AsyncStepWriter::Instance()
+{
+  static AsyncStepWriter instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncStepWriter::AsyncStepWriter()
+ : fFile(0),
+   fStopping(false),
+   fBytesWritten(0),
+   fFailed(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+AsyncStepWriter::~AsyncStepWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncStepWriter::Open(const G4String& fileName, G4int nProducers,
+                           const std::vector<char>& fileHeader)
+{
+  if (fFile) Close();
+  if (!fWrittenFiles.insert(fileName).second) {
+    G4ExceptionDescription description;
+    description << fileName << " already holds an earlier run of this job,"
+                << " refusing to overwrite it";
+    G4Exception("AsyncStepWriter::Open()", "Output002",
+                FatalException, description);
+    return;
+  }
+  fFile = std::fopen(fileName.c_str(), "wb");
+  if (!fFile) {
+    G4ExceptionDescription description;
+    description << "Cannot open " << fileName << " for writing";
+    G4Exception("AsyncStepWriter::Open()", "Output001",
+                FatalException, description);
+    return;
+  }
+  fBytesWritten = 0;
+  fFailed = false;
+  Write(fileHeader.data(), fileHeader.size());
+
+  // Two chunks per producer, allocated once for the whole run
+  G4int nChunks = 2 * (nProducers > 0 ? nProducers : 1);
+  for (G4int i = 0; i < nChunks; ++i) {
+    auto chunk = new std::vector<char>;
+    chunk->reserve(kChunkSize);
+    fAllChunks.push_back(chunk);
+    fFreeChunks.push_back(chunk);
+  }
+  fStopping = false;
+  fThread = std::thread(&AsyncStepWriter::WriteLoop, this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncStepWriter::Close()
+{
+  if (!fFile) return;
+  // The master's own chunk, when it is also the producer (sequential mode)
+  Flush();
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStopping = true;
+  }
+  fFullCondition.notify_all();
+  fThread.join();
+
+  if (std::fclose(fFile) != 0) Fail("close");
+  fFile = 0;
+  for (auto chunk : fAllChunks) delete chunk;
+  fAllChunks.clear();
+  fFreeChunks.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+char* AsyncStepWriter::Reserve(std::size_t nBytes)
+{
+  if (fCurrentChunk && fCurrentChunk->size() + nBytes > kChunkSize &&
+      !fCurrentChunk->empty()) {
+    Submit(fCurrentChunk);
+    fCurrentChunk = 0;
+  }
+  if (!fCurrentChunk) fCurrentChunk = AcquireFreeChunk();
+
+  // An event larger than a chunk simply grows its chunk
+  std::size_t offset = fCurrentChunk->size();
+  fCurrentChunk->resize(offset + nBytes);
+  return fCurrentChunk->data() + offset;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncStepWriter::Flush()
+{
+  if (!fCurrentChunk) return;
+  if (fCurrentChunk->empty()) {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fFreeChunks.push_back(fCurrentChunk);
+  }
+  else {
+    Submit(fCurrentChunk);
+  }
+  fCurrentChunk = 0;
+  fFreeCondition.notify_one();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<char>* AsyncStepWriter::AcquireFreeChunk()
+{
+  // Back-pressure: wait until the I/O thread has written a chunk out
+  std::unique_lock<std::mutex> lock(fMutex);
+  fFreeCondition.wait(lock, [this] { return !fFreeChunks.empty(); });
+  std::vector<char>* chunk = fFreeChunks.front();
+  fFreeChunks.pop_front();
+  chunk->clear();
+  return chunk;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncStepWriter::Submit(std::vector<char>* chunk)
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fFullChunks.push_back(chunk);
+  }
+  fFullCondition.notify_one();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncStepWriter::WriteLoop()
+{
+  for (;;) {
+    std::vector<char>* chunk = 0;
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fFullCondition.wait(lock, [this] {
+        return fStopping || !fFullChunks.empty(); });
+      if (fFullChunks.empty()) return;  // stopping and drained
+      chunk = fFullChunks.front();
+      fFullChunks.pop_front();
+    }
+
+    // The disk I/O happens outside the lock; after a failure the chunks
+    // are only recycled, so the producers are never blocked
+    std::uint32_t size = std::uint32_t(chunk->size());
+    if (Write(&size, sizeof(size))) Write(chunk->data(), chunk->size());
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fFreeChunks.push_back(chunk);
+    }
+    fFreeCondition.notify_one();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool AsyncStepWriter::Write(const void* data, std::size_t nBytes)
+{
+  if (fFailed) return false;
+  if (std::fwrite(data, 1, nBytes, fFile) != nBytes) {
+    Fail("write");
+    return false;
+  }
+  fBytesWritten += nBytes;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void AsyncStepWriter::Fail(const char* what)
+{
+  // Reported once; the bytes counted so far are those on disk
+  G4int error = errno;
+  if (fFailed.exchange(true)) return;
+  G4ExceptionDescription description;
+  description << "Cannot " << what << " the step file (" << std::strerror(error)
+              << "), it is incomplete after " << fBytesWritten.load()
+              << " bytes";
+  G4Exception("AsyncStepWriter::Write()", "Output003",
+              JustWarning, description);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
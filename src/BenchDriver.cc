@@ -0,0 +1,157 @@
+/// \file BenchDriver.cc
+/// \brief Implementation of the BenchDriver class
+
+#include "BenchDriver.hh"
+#include "ScanDriver.hh"
+#include "RunAction.hh"
+#include "SeedManager.hh"
+
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4UImanager.hh"
+#include "G4UIcommandStatus.hh"
+#include "G4Threading.hh"
+
+#include <fstream>
+#include <sstream>
+#include <sys/resource.h>
+
+namespace {
+  struct Workload {
+    const char* name;
+    const char* commands;   // separated by ';'
+  };
+
+  // Order matters: every run has its own event seeds (see SeedManager)
+  const Workload kWorkloads[] = {
+    { "neutron_NaI", "/Runmodel/ModelChoose NaI ; /gps/particle neutron ;"
+                     " /gps/ene/type Mono ; /gps/ene/mono 2.45 MeV" },
+    { "gamma_NaI",   "/Runmodel/ModelChoose NaI ; /gps/particle gamma ;"
+                     " /gps/ene/type Mono ; /gps/ene/mono 662 keV" },
+    { "neutron_CsI", "/Runmodel/ModelChoose CsI ; /gps/particle neutron ;"
+                     " /gps/ene/type Mono ; /gps/ene/mono 2.45 MeV" },
+    { "gamma_CsI",   "/Runmodel/ModelChoose CsI ; /gps/particle gamma ;"
+                     " /gps/ene/type Mono ; /gps/ene/mono 662 keV" }
+  };
+  const G4int kNumWorkloads = sizeof(kWorkloads) / sizeof(kWorkloads[0]);
+  // Starts the worker threads outside of the timed runs
+  const G4int kWarmupEvents = 10;
+
+  long PeakRSSkB()
+  {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+    return usage.ru_maxrss;  // kB on Linux
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BenchDriver::BenchDriver()
+{
+  fStartup.Start();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BenchDriver::~BenchDriver()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool BenchDriver::Run(const G4String& metricsFile, G4int nEvents)
+{
+  G4RunManager* runManager = G4RunManager::GetRunManager();
+  G4UImanager* uiManager = G4UImanager::GetUIpointer();
+
+  // Geometry, physics tables and cross sections are part of the startup
+  if (!ScanDriver::ApplyCommands(
+        "/control/verbose 0 ; /run/verbose 0 ; /event/verbose 0 ;"
+        " /tracking/verbose 0 ; /run/initialize ;"
+        " /gps/particle neutron ; /gps/pos/type Point ;"
+        " /gps/pos/centre 0 0 9.02 cm ; /gps/ang/type iso ;"
+        " /run/beamOn 0", "Benchmark")) return false;
+  fStartup.Stop();
+  G4double startupTime = fStartup.GetRealElapsed();
+
+  std::ostringstream warmup;
+  warmup << "/output/fileName bench_warmup ; /run/beamOn " << kWarmupEvents;
+  if (!ScanDriver::ApplyCommands(warmup.str(), "Benchmark")) return false;
+
+  std::ostringstream json;
+  json << "{\"seed\": " << SeedManager::GetBaseSeed()
+       << ", \"threads\": " << G4Threading::GetNumberOfRunningWorkerThreads()
+       << ", \"eventsPerWorkload\": " << nEvents
+       << ", \"startupSeconds\": " << startupTime
+       << ", \"workloads\": [";
+  G4bool ok = true;
+  for (G4int i = 0; i < kNumWorkloads; ++i) {
+    const Workload& workload = kWorkloads[i];
+    if (i > 0) json << ", ";
+    json << "{\"name\": \"" << workload.name << "\"";
+    // Settings first, then an empty run rebuilds what they changed
+    // (e.g. the physics tables of a new scintillator material)
+    G4String context = G4String("Benchmark ") + workload.name;
+    if (!ScanDriver::ApplyCommands(workload.commands, context) ||
+        !ScanDriver::ApplyCommands(G4String("/output/fileName bench_") +
+                                   workload.name + " ; /run/beamOn 0", context)) {
+      json << ", \"failed\": true}";
+      ok = false;
+      continue;
+    }
+
+    G4Timer timer;
+    std::ostringstream beamOn;
+    beamOn << "/run/beamOn " << nEvents;
+    timer.Start();
+    G4int status = uiManager->ApplyCommand(beamOn.str());
+    timer.Stop();
+
+    // An aborted run is not timed: its events/s would be meaningless
+    const G4Run* run = runManager->GetCurrentRun();
+    if (status != fCommandSucceeded || !run ||
+        run->GetNumberOfEvent() != nEvents) {
+      G4cerr << context << ": the timed run failed (status " << status
+             << ", " << (run ? run->GetNumberOfEvent() : 0) << " of "
+             << nEvents << " events)" << G4endl;
+      json << ", \"failed\": true}";
+      ok = false;
+      continue;
+    }
+
+    const RunAction* runAction =
+      static_cast<const RunAction*>(runManager->GetUserRunAction());
+    G4double seconds = timer.GetRealElapsed();
+    G4long nSteps = runAction->GetNumberOfSteps();
+    G4double bytes = runAction->GetOutputBytes();
+
+    G4cout << "Benchmark " << workload.name << ": " << nEvents/seconds
+           << " events/s, " << nSteps/seconds << " steps/s, "
+           << bytes/nEvents << " bytes/event" << G4endl;
+    json << ", \"events\": " << nEvents
+         << ", \"seconds\": " << seconds
+         << ", \"eventsPerSecond\": " << nEvents/seconds
+         << ", \"steps\": " << nSteps
+         << ", \"stepsPerSecond\": " << nSteps/seconds
+         << ", \"outputBytes\": " << bytes
+         << ", \"bytesPerEvent\": " << bytes/nEvents << "}";
+  }
+  // ru_maxrss is the peak of the whole process, so it is reported once
+  long peakRSS = PeakRSSkB();
+  G4cout << "Benchmark: process peak RSS " << peakRSS << " kB" << G4endl;
+  json << "], \"processPeakRSSkB\": " << peakRSS << "}";
+
+  std::ofstream out(metricsFile.c_str());
+  if (!out) {
+    G4ExceptionDescription description;
+    description << "Cannot write benchmark metrics to " << metricsFile;
+    G4Exception("BenchDriver::Run()", "Bench001", JustWarning, description);
+    G4cout << json.str() << G4endl;
+    return false;
+  }
+  out << json.str() << std::endl;
+  G4cout << "Benchmark metrics written to " << metricsFile << G4endl;
+  return ok;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
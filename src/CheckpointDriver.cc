@@ -0,0 +1,176 @@
+/// \file CheckpointDriver.cc
+/// \brief Implementation of the CheckpointDriver class
+
+#include "CheckpointDriver.hh"
+#include "CheckpointMessenger.hh"
+#include "SeedManager.hh"
+
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4UImanager.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointDriver::CheckpointDriver()
+: fMessenger(0)
+{
+  fMessenger = new CheckpointMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointDriver::~CheckpointDriver()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointDriver::BeamOn(G4int nEvents, G4int eventsPerSegment,
+                              const G4String& outputBase)
+{
+  // The segments keep the run ID the first one gets
+  const G4Run* previousRun = G4RunManager::GetRunManager()->GetCurrentRun();
+  State state;
+  state.outputBase = outputBase;
+  state.nEvents = nEvents;
+  state.eventsPerSegment = eventsPerSegment;
+  state.eventsDone = 0;
+  state.nextPart = 0;
+  state.runID = previousRun ? previousRun->GetRunID() + 1 : 0;
+  state.seed = SeedManager::GetBaseSeed();
+  state.jobIndex = SeedManager::GetJobIndex();
+  state.numJobs = SeedManager::GetNumJobs();
+  if (!Write(state)) return;
+  RunSegments(state);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointDriver::Resume(const G4String& checkpointFile)
+{
+  State state;
+  if (!Read(checkpointFile, state)) {
+    G4ExceptionDescription description;
+    description << "Cannot read checkpoint " << checkpointFile;
+    G4Exception("CheckpointDriver::Resume()", "Checkpoint001", JustWarning,
+                description);
+    return;
+  }
+  if (state.eventsDone >= state.nEvents) {
+    G4cout << "Checkpoint " << checkpointFile << ": all " << state.nEvents
+           << " events done" << G4endl;
+    return;
+  }
+  // The events are those of the original job, whatever --seed says
+  if (state.seed != SeedManager::GetBaseSeed() ||
+      state.jobIndex != SeedManager::GetJobIndex() ||
+      state.numJobs != SeedManager::GetNumJobs()) {
+    SeedManager::Configure(state.seed, state.jobIndex, state.numJobs);
+    SeedManager::SeedMaster();
+  }
+  G4cout << "Resuming " << state.outputBase << " at event " << state.eventsDone
+         << " of " << state.nEvents << ", part " << state.nextPart << G4endl;
+  RunSegments(state);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointDriver::RunSegments(State& state)
+{
+  G4UImanager* uiManager = G4UImanager::GetUIpointer();
+  while (state.eventsDone < state.nEvents) {
+    G4int nSegment = std::min(state.eventsPerSegment,
+                              state.nEvents - state.eventsDone);
+    std::ostringstream fileName;
+    fileName << "/output/fileName " << state.outputBase << "_part" << state.nextPart;
+    uiManager->ApplyCommand(fileName.str());
+
+    SeedManager::SetSegment(state.runID, state.eventsDone);
+    std::ostringstream beamOn;
+    beamOn << "/run/beamOn " << nSegment;
+    uiManager->ApplyCommand(beamOn.str());
+    SeedManager::ClearSegment();
+
+    // An aborted run (/run/abort) leaves the segment to be done again
+    const G4Run* run = G4RunManager::GetRunManager()->GetCurrentRun();
+    if (!run || run->GetNumberOfEvent() != nSegment) {
+      G4cerr << "Segment " << state.nextPart << " incomplete, stopping;"
+             << " resume from " << state.outputBase << ".checkpoint" << G4endl;
+      return;
+    }
+    state.eventsDone += nSegment;
+    ++state.nextPart;
+    if (!Write(state)) return;
+  }
+  G4cout << "Checkpointed run " << state.outputBase << ": " << state.nEvents
+         << " events in " << state.nextPart << " part(s)" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CheckpointDriver::Write(const State& state) const
+{
+  // Replaced in one step, a crash leaves the previous checkpoint
+  G4String fileName = state.outputBase + ".checkpoint";
+  G4String tmpFile = fileName + ".tmp";
+  {
+    std::ofstream out(tmpFile.c_str());
+    out << "outputBase " << state.outputBase << "\n"
+        << "nEvents " << state.nEvents << "\n"
+        << "eventsPerSegment " << state.eventsPerSegment << "\n"
+        << "eventsDone " << state.eventsDone << "\n"
+        << "nextPart " << state.nextPart << "\n"
+        << "runID " << state.runID << "\n"
+        << "seed " << state.seed << "\n"
+        << "jobIndex " << state.jobIndex << "\n"
+        << "numJobs " << state.numJobs << std::endl;
+    if (!out) {
+      G4ExceptionDescription description;
+      description << "Cannot write checkpoint " << tmpFile;
+      G4Exception("CheckpointDriver::Write()", "Checkpoint002", JustWarning,
+                  description);
+      return false;
+    }
+  }
+  std::rename(tmpFile.c_str(), fileName.c_str());
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool CheckpointDriver::Read(const G4String& fileName, State& state) const
+{
+  std::ifstream in(fileName.c_str());
+  if (!in) return false;
+  std::map<std::string, std::string> values;
+  std::string key, value;
+  while (in >> key >> value) values[key] = value;
+
+  const char* keys[] = { "outputBase", "nEvents", "eventsPerSegment",
+                         "eventsDone", "nextPart", "runID", "seed",
+                         "jobIndex", "numJobs" };
+  for (const char* required : keys) {
+    if (values.find(required) == values.end()) return false;
+  }
+  state.outputBase = values["outputBase"];
+  state.nEvents = std::atoi(values["nEvents"].c_str());
+  state.eventsPerSegment = std::atoi(values["eventsPerSegment"].c_str());
+  state.eventsDone = std::atoi(values["eventsDone"].c_str());
+  state.nextPart = std::atoi(values["nextPart"].c_str());
+  state.runID = std::atoi(values["runID"].c_str());
+  state.seed = std::atol(values["seed"].c_str());
+  state.jobIndex = std::atoi(values["jobIndex"].c_str());
+  state.numJobs = std::atoi(values["numJobs"].c_str());
+  return state.eventsPerSegment > 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
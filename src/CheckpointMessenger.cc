@@ -0,0 +1,67 @@
+#include "CheckpointMessenger.hh"
+#include "CheckpointDriver.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointMessenger::CheckpointMessenger(CheckpointDriver * driver)
+:fDriver(driver)
+{ 
+  fCheckpointDir = new G4UIdirectory("/checkpoint/");
+  fCheckpointDir->SetGuidance("Runs in segments that can be resumed.");
+
+  fBeamOnCmd = new G4UIcommand("/checkpoint/beamOn",this);
+  fBeamOnCmd->SetGuidance("Run nEvents in segments of eventsPerSegment, each");
+  fBeamOnCmd->SetGuidance("written to <outputBase>_part<k>, with a checkpoint");
+  fBeamOnCmd->SetGuidance("<outputBase>.checkpoint after every segment.");
+  G4UIparameter* eventsParam = new G4UIparameter("nEvents",'i',false);
+  eventsParam->SetParameterRange("nEvents>0");
+  fBeamOnCmd->SetParameter(eventsParam);
+  G4UIparameter* segmentParam = new G4UIparameter("eventsPerSegment",'i',false);
+  segmentParam->SetParameterRange("eventsPerSegment>0");
+  fBeamOnCmd->SetParameter(segmentParam);
+  G4UIparameter* outputParam = new G4UIparameter("outputBase",'s',false);
+  fBeamOnCmd->SetParameter(outputParam);
+  fBeamOnCmd->AvailableForStates(G4State_Idle);
+  fBeamOnCmd->SetToBeBroadcasted(false);
+
+  fResumeCmd = new G4UIcmdWithAString("/checkpoint/resume",this);
+  fResumeCmd->SetGuidance("Continue a run from its checkpoint file, after the");
+  fResumeCmd->SetGuidance("configuration commands of the original macro.");
+  fResumeCmd->SetParameterName("checkpointFile",false);
+  fResumeCmd->AvailableForStates(G4State_Idle);
+  fResumeCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CheckpointMessenger::~CheckpointMessenger()
+{
+  delete fBeamOnCmd;
+  delete fResumeCmd;
+  delete fCheckpointDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CheckpointMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{ 
+  if( command == fBeamOnCmd )
+  {
+    G4int nEvents = 0, eventsPerSegment = 0;
+    G4String outputBase;
+    std::istringstream is(newValue);
+    is >> nEvents >> eventsPerSegment >> outputBase;
+    fDriver->BeamOn(nEvents, eventsPerSegment, outputBase);
+  }
+  if( command == fResumeCmd )
+  {
+    fDriver->Resume(newValue);
+  }
+}
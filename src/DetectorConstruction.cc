@@ -2,6 +2,9 @@
 /// \brief Implementation of the DetectorConstruction class
 
 #include "DetectorConstruction.hh"
+#include "RecordSD.hh"
+#include "ImportanceBiasingOperator.hh"
+#include "ScintorArrayParameterisation.hh"
 
 #include "G4RunManager.hh"
 #include "G4NistManager.hh"
@@ -19,14 +22,60 @@
 #include "G4TessellatedSolid.hh"
 #include "G4Polycone.hh"
 #include <G4SubtractionSolid.hh>
+#include "G4MultiUnion.hh"
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
+#include "G4PVParameterised.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4ExtrudedSolid.hh"
 #include <G4VisAttributes.hh>
+#include "G4SDManager.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4ProductionCuts.hh"
+#include "G4UserLimits.hh"
+#include "G4BOptrForceCollision.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "NavigationBenchmark.hh"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef G4LIB_USE_GDML
+#include "G4GDMLParser.hh"
+#endif
 
 #define pi 3.14159265359
 
+namespace {
+  // TPC Teflon walls around the LXe, and the largest radius of the
+  // stainless steel container (its flanges)
+  const G4double kTPCSideWall = 0.55*cm;
+  const G4double kTPCEndWall = 0.25*cm;
+  const G4double kSSContainerInnerRadius = 12.4*cm;
+  const G4double kSSContainerOuterRadius = 12.7*cm;
+  const G4double kSSContainerHalfLength = 22.5*cm;
+  const G4double kSSContainerMaxRadius = 15.2*cm;
+  const G4double kSSContainerFlangeHalfThickness = 1.5*cm;
+  // Default scintillator array
+  const G4int kScintorNPhi = 8;
+  const G4int kScintorNLayers = 5;
+  const G4double kScintorHalfSize = 3.0*cm;
+  const G4double kScintorLayerGap = 2.0*cm;
+  // Half size of the world
+  const G4double kWorldHalfXY = 0.5*m;
+  const G4double kWorldHalfZ = 1.0*m;
+}
+
+G4ThreadLocal G4BOptrForceCollision* DetectorConstruction::fForceCollision = 0;
+G4ThreadLocal ImportanceBiasingOperator* DetectorConstruction::fImportance = 0;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::DetectorConstruction()
@@ -34,7 +83,39 @@ DetectorConstruction::DetectorConstruction()
 {
     fDetectorMessenger = new DetectorMessenger(this);
     RunModel = "NaI";
-    DefineMaterial();
+    fCheckOverlaps = false;
+    fScintorLV = 0;
+    // TPC Teflon：外高18.54cm，外半径8.3cm，侧壁厚度0.55cm，顶部/底部厚0.25cm
+    Xeradius = 8.3*cm - kTPCSideWall;
+    Xehalflength = 18.54*0.5*cm - kTPCEndWall;
+    disctancefromXe = kSSContainerMaxRadius + 1.0*cm + kScintorHalfSize;
+    fScintorNPhi = kScintorNPhi;
+    fScintorNLayers = kScintorNLayers;
+    fScintorHalfSize = kScintorHalfSize;
+    fScintorLayerGap = kScintorLayerGap;
+    fContainerSolid = "polycone";
+    // Shielding and floor are not part of the current geometry; their
+    // parameters are kept for the models that build them
+    Pb1thickness = 0.;
+    Pb2thickness = 0.;
+    BPEthickness = 0.;
+    ConstructFloor = false;
+    fMaterialsDefined = false;
+    AddSensitiveVolume("logicXecylinder", "Xe");
+    AddSensitiveVolume("LogicScintor", "scintor");
+
+    // The recorded volumes keep the former global cuts; the world region
+    // only takes user limits, its cuts are the physics list defaults
+    fRegionsDefined = false;
+    RegionSettings target = { "LXeTarget", { 1*mm, 1*mm, 1*mm, 0.1*mm },
+                              0., 0., 0., 0 };
+    RegionSettings scintor = { "Scintillators", { 1*mm, 1*mm, 1*mm, 0.1*mm },
+                               0., 0., 0., 0 };
+    RegionSettings world = { "DefaultRegionForTheWorld", { -1., -1., -1., -1. },
+                             0., 0., 0., 0 };
+    fRegions.push_back(target);
+    fRegions.push_back(scintor);
+    fRegions.push_back(world);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -47,76 +128,107 @@ DetectorConstruction::~DetectorConstruction()
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 void DetectorConstruction::DefineMaterial()
 {
+  fMaterialsDefined = true;
   G4NistManager* nist = G4NistManager::Instance();
-  G4Element *D = new G4Element("Deuterium", "D", 1);
+  // A geometry read from the GDML cache brings the elements and materials
+  // it uses: those are taken by name, only the missing ones are defined
+  auto element = [](const G4String& name, const G4String& symbol,
+                    G4double z, G4double a) {
+    G4Element* found = G4Element::GetElement(name, false);
+    return found ? found : new G4Element(name, symbol, z, a);
+  };
+  G4Element *D = G4Element::GetElement("Deuterium", false);
+  if (!D) {
+    D = new G4Element("Deuterium", "D", 1);
+    G4Isotope *D_Iso = new G4Isotope("D_Iso", 1, 2, 2.014102 * g / mole);
+    D->AddIsotope(D_Iso, 1);
+  }
   G4Element *B = nist->FindOrBuildElement("B");
-  G4Element *H = new G4Element("Hydrogen", "H", 1., 1.0079 * g / mole);
-  G4Element *C = new G4Element("Carbon", "C", 6., 12.011 * g / mole);
-  G4Element *N = new G4Element("Nitrogen", "N", 7., 14.007 * g / mole);
-  G4Element *O = new G4Element("Oxygen", "O", 8., 15.999 * g / mole);
-  G4Element *F = new G4Element("Fluorine", "F", 9., 18.998 * g / mole);
-  G4Element *Si = new G4Element("Silicon", "Si", 14., 28.086 * g / mole);
-  G4Element *Cr = new G4Element("Chromium", "Cr", 24., 51.996 * g / mole);
-  G4Element *Mn = new G4Element("Manganese", "Mn", 25., 54.938 * g / mole);
-  G4Element *Fe = new G4Element("Iron", "Fe", 26., 55.85 * g / mole);
-  G4Element *Ni = new G4Element("Nickel", "Ni", 28., 58.693 * g / mole);
-  G4Element* Ar = new G4Element("Argon", "Ar", 18., 39.948*g/mole);
-  G4Element* elNa = new G4Element("Sodium", "Na", 11., 22.989770*g/mole);
-  G4Element* elI = new G4Element("Iodine", "I", 53., 126.90447*g/mole);
-
-  G4Isotope *D_Iso = new G4Isotope("D_Iso", 1, 2, 2.014102 * g / mole);
-  D->AddIsotope(D_Iso, 1);
-
-  G4Element *Xe = new G4Element("Xenon", "Xe", 54., 131.293 * g / mole);
-  LXe = new G4Material("LXe", 2.862 * g / cm3, 1, kStateLiquid,
-                                   177.05 * kelvin, 1.5 * atmosphere);
-  
-  // DR 20180518 - Density according to:
-  // -
-  // https://xe1t-wiki.lngs.infn.it/doku.php?id=xenon:xenon1t:deg:tpc:targetmass
-  // -
-  // https://xe1t-wiki.lngs.infn.it/doku.php?id=xenon:xenon1t:analysis:sciencerun1:sc_summary
-  LXe->AddElement(Xe, 1);
-  G4Element* elCu = new G4Element("Copper", "Cu", 29., 63.546*g/mole);
+  G4Element *H = element("Hydrogen", "H", 1., 1.0079 * g / mole);
+  G4Element *C = element("Carbon", "C", 6., 12.011 * g / mole);
+  G4Element *N = element("Nitrogen", "N", 7., 14.007 * g / mole);
+  G4Element *O = element("Oxygen", "O", 8., 15.999 * g / mole);
+  G4Element *F = element("Fluorine", "F", 9., 18.998 * g / mole);
+  G4Element *Si = element("Silicon", "Si", 14., 28.086 * g / mole);
+  G4Element *Cr = element("Chromium", "Cr", 24., 51.996 * g / mole);
+  G4Element *Mn = element("Manganese", "Mn", 25., 54.938 * g / mole);
+  G4Element *Fe = element("Iron", "Fe", 26., 55.85 * g / mole);
+  G4Element *Ni = element("Nickel", "Ni", 28., 58.693 * g / mole);
+  G4Element* Ar = element("Argon", "Ar", 18., 39.948*g/mole);
+  G4Element* elNa = element("Sodium", "Na", 11., 22.989770*g/mole);
+  G4Element* elI = element("Iodine", "I", 53., 126.90447*g/mole);
 
-  Cu = new G4Material("Copper_manual", 8.96*g/cm3, 1);
-  Cu->AddElement(elCu, 1.0); 
+  G4Element *Xe = element("Xenon", "Xe", 54., 131.293 * g / mole);
+  LXe = G4Material::GetMaterial("LXe", false);
+  if (!LXe) {
+    LXe = new G4Material("LXe", 2.862 * g / cm3, 1, kStateLiquid,
+                                     177.05 * kelvin, 1.5 * atmosphere);
+
+    // DR 20180518 - Density according to:
+    // -
+    // https://xe1t-wiki.lngs.infn.it/doku.php?id=xenon:xenon1t:deg:tpc:targetmass
+    // -
+    // https://xe1t-wiki.lngs.infn.it/doku.php?id=xenon:xenon1t:analysis:sciencerun1:sc_summary
+    LXe->AddElement(Xe, 1);
+  }
+  G4Element* elCu = element("Copper", "Cu", 29., 63.546*g/mole);
+
+  Cu = G4Material::GetMaterial("Copper_manual", false);
+  if (!Cu) {
+    Cu = new G4Material("Copper_manual", 8.96*g/cm3, 1);
+    Cu->AddElement(elCu, 1.0); 
+  }
 
   Air = nist->FindOrBuildMaterial("G4_AIR");
   Water = nist->FindOrBuildMaterial("G4_WATER");
   Pb = nist->FindOrBuildMaterial("G4_Pb");
   //
   
-  epoxy = new G4Material("Epoxy_Resin", 1.14*g/cm3, 3); // 密度约为 1.14 g/cm³
-  epoxy->AddElement(C, 15); // 假设化学式为 C15H22O2 (示例)
-  epoxy->AddElement(H, 22);
-  epoxy->AddElement(O,  2);
+  epoxy = G4Material::GetMaterial("Epoxy_Resin", false);
+  if (!epoxy) {
+    epoxy = new G4Material("Epoxy_Resin", 1.14*g/cm3, 3); // 密度约为 1.14 g/cm³
+    epoxy->AddElement(C, 15); // 假设化学式为 C15H22O2 (示例)
+    epoxy->AddElement(H, 22);
+    epoxy->AddElement(O,  2);
+  }
   // --- 3. 定义玻璃纤维 (Glass Fiber) ---
   // 玻璃纤维主要成分是二氧化硅 (SiO2)
-  silica = new G4Material("Silica", 2.200*g/cm3, 2);
-  silica->AddElement(Si, 1);
-  silica->AddElement(O, 2);
+  silica = G4Material::GetMaterial("Silica", false);
+  if (!silica) {
+    silica = new G4Material("Silica", 2.200*g/cm3, 2);
+    silica->AddElement(Si, 1);
+    silica->AddElement(O, 2);
+  }
   
   // --- 4. 创建玻璃纤维板复合材料 (G4_Composite) ---
   // 使用 G4Material 来创建复合材料，按质量分数混合
-  GlassFiber = new G4Material("GlassFiberBoard", 1.86*g/cm3, 2); // 典型密度约为 1.86 g/cm³
-  GlassFiber->AddMaterial(silica, 0.6); // 玻璃纤维占 60%
-  GlassFiber->AddMaterial(epoxy,  0.4); // 环氧树脂占 40%
+  GlassFiber = G4Material::GetMaterial("GlassFiberBoard", false);
+  if (!GlassFiber) {
+    GlassFiber = new G4Material("GlassFiberBoard", 1.86*g/cm3, 2); // 典型密度约为 1.86 g/cm³
+    GlassFiber->AddMaterial(silica, 0.6); // 玻璃纤维占 60%
+    GlassFiber->AddMaterial(epoxy,  0.4); // 环氧树脂占 40%
+  }
   // --- 定义玻璃纤维复合材料 ---
 
   //==== Stainless Steel ====
 
-  SS304LSteel = new G4Material("SS304LSteel", 8.00 * g / cm3, 5, kStateSolid);
-  SS304LSteel->AddElement(Fe, 0.65);
-  SS304LSteel->AddElement(Cr, 0.20);
-  SS304LSteel->AddElement(Ni, 0.12);
-  SS304LSteel->AddElement(Mn, 0.02);
-  SS304LSteel->AddElement(Si, 0.01);
+  SS304LSteel = G4Material::GetMaterial("SS304LSteel", false);
+  if (!SS304LSteel) {
+    SS304LSteel = new G4Material("SS304LSteel", 8.00 * g / cm3, 5, kStateSolid);
+    SS304LSteel->AddElement(Fe, 0.65);
+    SS304LSteel->AddElement(Cr, 0.20);
+    SS304LSteel->AddElement(Ni, 0.12);
+    SS304LSteel->AddElement(Mn, 0.02);
+    SS304LSteel->AddElement(Si, 0.01);
+  }
 
   //==== ePTFE ==== Expanded PTFE (as Teflon, but lower density, used in the nVeto reflector)
-  ePTFE = new G4Material("ePTFE", 0.7 * g / cm3, 2, kStateSolid);
-  ePTFE->AddElement(C, 0.240183);
-  ePTFE->AddElement(F, 0.759817);
+  ePTFE = G4Material::GetMaterial("ePTFE", false);
+  if (!ePTFE) {
+    ePTFE = new G4Material("ePTFE", 0.7 * g / cm3, 2, kStateSolid);
+    ePTFE->AddElement(C, 0.240183);
+    ePTFE->AddElement(F, 0.759817);
+  }
   //==== EJ-276 for Scintillator target in BeamPipe ====
 
   //G4double EJ276_density = 1.099 * g / cm3;
@@ -133,9 +245,12 @@ void DetectorConstruction::DefineMaterial()
   G4double H_Frac = H_MassDensity/HC_density;
   G4double C_Frac 	= C_MassDensity/HC_density;
 
-  EJ276 = new G4Material("EJ276", HC_density, 2, kStateSolid);
-  EJ276->AddElement(nist->FindOrBuildElement("H"), H_Frac);
-  EJ276->AddElement(nist->FindOrBuildElement("C"), C_Frac);
+  EJ276 = G4Material::GetMaterial("EJ276", false);
+  if (!EJ276) {
+    EJ276 = new G4Material("EJ276", HC_density, 2, kStateSolid);
+    EJ276->AddElement(nist->FindOrBuildElement("H"), H_Frac);
+    EJ276->AddElement(nist->FindOrBuildElement("C"), C_Frac);
+  }
 
   G4cout << "EJ276 : density " <<  EJ276->GetDensity()/(g / cm3) << " , "
          << "NbOfAtomsPerVolume " << EJ276->GetTotNbOfAtomsPerVolume()/(1. / cm3) << G4endl;
@@ -157,10 +272,13 @@ void DetectorConstruction::DefineMaterial()
   G4double density_air = (pressure * molarMass_air) / (gas_constant * temperature);
 
   // 步骤3：创建空气材料（按元素组成定义，匹配真实空气成分）
-  air = new G4Material("Air_1e-7bar", density_air, 3);
-  air->AddElement(N, 0.78);  // 氮占78%（体积/摩尔分数）
-  air->AddElement(O, 0.21);  // 氧占21%
-  air->AddElement(Ar, 0.01); // 氩占1%
+  air = G4Material::GetMaterial("Air_1e-7bar", false);
+  if (!air) {
+    air = new G4Material("Air_1e-7bar", density_air, 3);
+    air->AddElement(N, 0.78);  // 氮占78%（体积/摩尔分数）
+    air->AddElement(O, 0.21);  // 氧占21%
+    air->AddElement(Ar, 0.01); // 氩占1%
+  }
 
   G4cout << "✅ 1e-7 bar air" 
           << "density = " << air->GetDensity()/(g/cm3) << " g/cm³，"
@@ -168,29 +286,38 @@ void DetectorConstruction::DefineMaterial()
 
   // ======================== NaI ========================
 
-  NaI = new G4Material("NaI", 3.67*g/cm3, 2);
-  NaI->AddElement(elNa, 1);
-  NaI->AddElement(elI, 1);
+  NaI = G4Material::GetMaterial("NaI", false);
+  if (!NaI) {
+    NaI = new G4Material("NaI", 3.67*g/cm3, 2);
+    NaI->AddElement(elNa, 1);
+    NaI->AddElement(elI, 1);
+  }
   G4cout << "✅ NaI finished:density " << NaI->GetDensity()/(g/cm3) << " g/cm³" << G4endl;
 
   // ======================== CsI ========================
 
-  G4Element* elCs = new G4Element("Cesium", "Cs", 55., 132.90545*g/mole);
-  CsI = new G4Material("CsI", 4.51*g/cm3, 2);
-  CsI->AddElement(elCs, 1);
-  CsI->AddElement(elI, 1);
+  G4Element* elCs = element("Cesium", "Cs", 55., 132.90545*g/mole);
+  CsI = G4Material::GetMaterial("CsI", false);
+  if (!CsI) {
+    CsI = new G4Material("CsI", 4.51*g/cm3, 2);
+    CsI->AddElement(elCs, 1);
+    CsI->AddElement(elI, 1);
+  }
   G4cout << "✅CsI 材finished:density " << CsI->GetDensity()/(g/cm3) << " g/cm³" << G4endl;
 
   //===========================BPE===========================================
   
 
-  BPE = new G4Material("B_poly", 0.93 * g / cm3, 4,
-    kStateSolid);  // B-doped, from
-  // http://lss.fnal.gov/archive/2000/fn/FN-697.pdf
-  BPE->AddElement(nist->FindOrBuildElement("H"), 0.116);
-  BPE->AddElement(nist->FindOrBuildElement("C"), 0.612);
-  BPE->AddElement(nist->FindOrBuildElement("B"), 0.05);
-  BPE->AddElement(nist->FindOrBuildElement("O"), 0.222);
+  BPE = G4Material::GetMaterial("B_poly", false);
+  if (!BPE) {
+    BPE = new G4Material("B_poly", 0.93 * g / cm3, 4,
+      kStateSolid);  // B-doped, from
+    // http://lss.fnal.gov/archive/2000/fn/FN-697.pdf
+    BPE->AddElement(nist->FindOrBuildElement("H"), 0.116);
+    BPE->AddElement(nist->FindOrBuildElement("C"), 0.612);
+    BPE->AddElement(nist->FindOrBuildElement("B"), 0.05);
+    BPE->AddElement(nist->FindOrBuildElement("O"), 0.222);
+  }
 
   G4cout << "BPE : density " <<  BPE->GetDensity()/(g / cm3) << " , "
          << "NbOfAtomsPerVolume " << BPE->GetTotNbOfAtomsPerVolume()/(1. / cm3) << G4endl;
@@ -202,12 +329,18 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   // Option to switch on/off checking of volumes overlaps
   //
   //G4double DistanccFromXeToFloor = 1.625*m + Pbthickness*cm + (102.05+231.32)*mm;//1.6*m + 293.2*mm - 25.0*cm + Xehalflength*cm;
-  G4bool checkOverlaps = true;
+  G4bool checkOverlaps = fCheckOverlaps;
+
+  // A cached geometry skips the materials and the overlap checks; after
+  // it, only the materials it did not bring are defined
+  G4VPhysicalVolume* cached = ReadGdmlCache();
+  if (cached) return cached;
+  if (!fMaterialsDefined) DefineMaterial();
   
   
   // World
-  G4double world_sizeZ = 1.0*m;
-  G4double world_sizeXY = 0.5*m;
+  G4double world_sizeZ = kWorldHalfZ;
+  G4double world_sizeXY = kWorldHalfXY;
   
   G4Box* solidWorld =    
     new G4Box("World",                       //its name
@@ -236,10 +369,9 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   ConstructSheild(logicWorld);*/
   // LXe cyclinder
   // TPC Teflon：外高18.54cm，外半径8.3cm（对应直径16.6cm），侧壁厚度0.55cm，顶部厚0.25cm，底部厚0.25cm
-  G4double Xeradius = (8.3 - 0.55)*cm; // cm
-  G4double Xehalflength = (18.54*0.5 - 0.25)*cm; // cm
-  G4double TPCXeradius = 8.3*cm; // cm
-  G4double TPCHalflength = (18.54*0.5)*cm;
+  // LXe 尺寸见 setXeradius / setXehalflength (/Runmodel/setXeradius ...)
+  G4double TPCXeradius = Xeradius + kTPCSideWall;
+  G4double TPCHalflength = Xehalflength + kTPCEndWall;
   G4Tubs* solidTPC =    
     new G4Tubs("TPC",                    //its name
         0, TPCXeradius, TPCHalflength,0, 360*deg); //its size
@@ -271,7 +403,7 @@ new G4PVPlacement(0,           // rotation
   logicXecylinder->SetVisAttributes(LXevisAttr);
 
   G4cout<<"Construct Xe cylinder with radius is "
-  <<Xeradius<<" cm, half hight is "<<Xehalflength<<" cm.";
+  <<Xeradius/cm<<" cm, half hight is "<<Xehalflength/cm<<" cm."<<G4endl;
    
   new G4PVPlacement(0,           // rotation 
                     G4ThreeVector(0,0,0),         //at (0,0,0)
@@ -285,21 +417,51 @@ new G4PVPlacement(0,           // rotation
   //不锈钢罐体侧壁高45cm，外半径12.7cm，厚度0.3cm
   //顶盖厚3cm，半径15.2cm
   //底盖厚3cm，半径15.2cm
-  G4double SSContainerOutterradius = 12.7*cm;
-  G4double SSContainerInnerradius = 12.4*cm;
-  G4double SSContainerHalflength = 22.5*cm;
-  G4Tubs* solidSSContainer =    
-    new G4Tubs("SSContainer",                    //its name
-        SSContainerInnerradius, SSContainerOutterradius, SSContainerHalflength,0, 360*deg); //its size 
-  G4Tubs* solidSSContainerFlange =    
-    new G4Tubs("SSContainerTop",                    //its name
-        0, 15.2*cm, 0.5*3.0*cm,0, 360*deg); //its size
-  G4UnionSolid* solidSSContainerWithFlange = new G4UnionSolid("SSContainerWithTop",
-                           solidSSContainer,
-                           solidSSContainerFlange, 0, G4ThreeVector(0,0,SSContainerHalflength+1.5*cm));
-  solidSSContainerWithFlange = new G4UnionSolid("SSContainerWithTop",
-                           solidSSContainerWithFlange,
-                           solidSSContainerFlange, 0, G4ThreeVector(0,0,-SSContainerHalflength-1.5*cm));  
+  G4double SSContainerOutterradius = kSSContainerOuterRadius;
+  G4double SSContainerInnerradius = kSSContainerInnerRadius;
+  G4double SSContainerHalflength = kSSContainerHalfLength;
+  G4double SSContainerFlangeRadius = kSSContainerMaxRadius;
+  G4double SSContainerFlangeHalfThickness = kSSContainerFlangeHalfThickness;
+  // 同一形状的三种实现 (/Runmodel/containerSolid)：polycone 导航最快，
+  // boolean 为原来的 G4UnionSolid，multiunion 为体素化的 G4MultiUnion
+  G4VSolid* solidSSContainerWithFlange = 0;
+  if (fContainerSolid == "polycone") {
+    G4double flangeZ = SSContainerHalflength + 2*SSContainerFlangeHalfThickness;
+    G4double zPlanes[6] = { -flangeZ, -SSContainerHalflength, -SSContainerHalflength,
+                            SSContainerHalflength, SSContainerHalflength, flangeZ };
+    G4double rInner[6] = { 0., 0., SSContainerInnerradius,
+                           SSContainerInnerradius, 0., 0. };
+    G4double rOuter[6] = { SSContainerFlangeRadius, SSContainerFlangeRadius,
+                           SSContainerOutterradius, SSContainerOutterradius,
+                           SSContainerFlangeRadius, SSContainerFlangeRadius };
+    solidSSContainerWithFlange = new G4Polycone("SSContainerWithTop", 0, 360*deg,
+                                                6, zPlanes, rInner, rOuter);
+  } else {
+    G4Tubs* solidSSContainer =    
+      new G4Tubs("SSContainer",                    //its name
+          SSContainerInnerradius, SSContainerOutterradius, SSContainerHalflength,0, 360*deg); //its size 
+    G4Tubs* solidSSContainerFlange =    
+      new G4Tubs("SSContainerTop",                    //its name
+          0, SSContainerFlangeRadius, SSContainerFlangeHalfThickness,0, 360*deg); //its size
+    G4ThreeVector flangePosition(0,0,SSContainerHalflength+SSContainerFlangeHalfThickness);
+    if (fContainerSolid == "multiunion") {
+      G4MultiUnion* multiUnion = new G4MultiUnion("SSContainerWithTop");
+      multiUnion->AddNode(*solidSSContainer, G4Transform3D());
+      multiUnion->AddNode(*solidSSContainerFlange,
+                          G4Transform3D(G4RotationMatrix(), flangePosition));
+      multiUnion->AddNode(*solidSSContainerFlange,
+                          G4Transform3D(G4RotationMatrix(), -flangePosition));
+      multiUnion->Voxelize();
+      solidSSContainerWithFlange = multiUnion;
+    } else {
+      G4UnionSolid* unionSolid = new G4UnionSolid("SSContainerWithOneTop",
+                               solidSSContainer,
+                               solidSSContainerFlange, 0, flangePosition);
+      solidSSContainerWithFlange = new G4UnionSolid("SSContainerWithTop",
+                               unionSolid,
+                               solidSSContainerFlange, 0, -flangePosition);
+    }
+  }
   G4LogicalVolume* logicSSContainer =                         
     new G4LogicalVolume(solidSSContainerWithFlange,            //its solid
                         SS304LSteel,             //its material
@@ -314,8 +476,8 @@ new G4PVPlacement(0,           // rotation
                     checkOverlaps);          //overlaps checking
 
   // ==================== Scintor ==================
-  G4double Cubesize = 3.0*cm;
-  G4String NaICube_namePrefix = "NaICube_";
+  // 阵列参数见 /Runmodel/scintor/ 命令，默认 8 x 5 个边长 6cm 的立方体
+  G4double Cubesize = fScintorHalfSize;
 
   G4Box* solidNaICube = new G4Box(
       "SolidNaICube",                  // 固体名称
@@ -332,65 +494,531 @@ new G4PVPlacement(0,           // rotation
   );
 
   // 核心思路：以容器中心为原点，在 X-Y 平面（环绕容器径向）和 Z 轴（容器轴向）分布，
-  // 确保立方体不与容器重叠，且间距合理（可调整 gap 参数）
+  // 确保立方体不与容器重叠（见 ScintorArrayFits）
   G4double container_centerZ = Xehalflength; // 容器中心Z坐标（与你的容器物理体一致）
-  G4double container_maxRadius = 15.2*cm;    // 容器最大半径（法兰外半径15.2cm）
-  G4double cube_gap = 1.0*cm;                // 立方体与容器/立方体之间的间隙（可调整）
-  G4double cube_outerRadius = container_maxRadius + cube_gap + Cubesize; // 立方体中心到Z轴的距离
-
-  // 定义阵列维度：X-Y平面环绕数（周向）、Z轴层数（轴向）
-  G4int num_phi = 8;         // 周向均匀分布8个立方体（可调整，如6/12个）
-  G4int num_z_layers = 5;    // Z轴方向3层（可调整，如2/4层）
-  G4double z_layer_gap = 2.0*cm; // Z轴层间间隙（可调整）
-
-  // 计算Z轴各层中心坐标（以容器中心为基准，上下对称分布）
-  std::vector<G4double> z_positions;
-  G4double z_start = container_centerZ - (num_z_layers-1)*(Cubesize*2 + z_layer_gap)/2;
-  for (G4int z_idx = 0; z_idx < num_z_layers; z_idx++) {
-      z_positions.push_back(z_start + z_idx*(Cubesize*2 + z_layer_gap));
-  }
+  // 立方体中心到Z轴的距离 (/Runmodel/setScintorDistance)，默认比法兰外半径
+  // 15.2cm 多 1cm 间隙加半边长
+  G4double cube_outerRadius = disctancefromXe;
+  G4int num_phi = fScintorNPhi;
+  G4int num_z_layers = fScintorNLayers;
+  G4double z_layer_pitch = Cubesize*2 + fScintorLayerGap;
 
-  // ======================================
-  // 4. 循环创建NaI立方体物理体（阵列分布）
-  // ======================================
-  G4int cube_copyNum = 0; // 复制编号（用于区分不同立方体）
-  for (G4int z_idx = 0; z_idx < num_z_layers; z_idx++) { // 遍历Z轴各层
-      for (G4int phi_idx = 0; phi_idx < num_phi; phi_idx++) { // 遍历周向各位置
-          // 计算当前立方体的中心坐标（极坐标转直角坐标）
-          G4double phi = phi_idx * (360.0*deg / num_phi); // 周向角度（均匀分布）
-          G4double x_pos = cube_outerRadius * cos(phi);
-          G4double y_pos = cube_outerRadius * sin(phi);
-          G4double z_pos = z_positions[z_idx];
-          G4ThreeVector cube_center(x_pos, y_pos, z_pos);
-
-          // 创建物理体（放置在世界逻辑体中，与容器同级）
-          new G4PVPlacement(
-              0,                      // 旋转（无旋转，保持立方体轴与世界轴一致）
-              cube_center,            // 立方体中心坐标
-              logicNaICube,           // 关联的逻辑体
-              "Scintor", // 物理体名称（唯一）
-              logicWorld,             // 母逻辑体（与容器相同，均为世界逻辑体）
-              false,                  // 无布尔运算
-              cube_copyNum,           // 复制编号（唯一）
-              checkOverlaps           // 重叠检查（与容器一致）
-          );
-          cube_copyNum++;
-      }
-  }
+  // 所有立方体是同一个参数化物理体，放在包住整个阵列的空气圆筒里：
+  // 参数化体必须是母体唯一的子体，内存和构建时间不随立方体数增长
+  G4double arrayInnerRadius, arrayOuterRadius, arrayHalfLength;
+  ScintorArrayExtent(arrayInnerRadius, arrayOuterRadius, arrayHalfLength);
+  G4Tubs* solidScintorArray =
+    new G4Tubs("ScintorArray", arrayInnerRadius, arrayOuterRadius,
+               arrayHalfLength, 0, 360*deg);
+  G4LogicalVolume* logicScintorArray =
+    new G4LogicalVolume(solidScintorArray, air, "LogicScintorArray");
+  new G4PVPlacement(0,
+                    G4ThreeVector(0,0,container_centerZ),
+                    logicScintorArray,
+                    "ScintorArray",
+                    logicWorld,
+                    false,
+                    0,
+                    checkOverlaps);
+  logicScintorArray->SetVisAttributes(G4VisAttributes::GetInvisible());
 
-  G4cout << "\n📋 Creat " << cube_copyNum << " Scintor Cube(" 
-        << num_z_layers << "  X " << num_phi << " )" << G4endl;
+  // 复制编号 = 层号*num_phi + 周向编号，与原来逐个放置时相同
+  ScintorArrayParameterisation* scintorArrayParam =
+    new ScintorArrayParameterisation(num_phi, num_z_layers, cube_outerRadius,
+                                     z_layer_pitch);
+  new G4PVParameterised("Scintor",
+                        logicNaICube,
+                        logicScintorArray,
+                        kUndefined,       // 由 Geant4 选择体素化方向
+                        scintorArrayParam->GetNumberOfCubes(),
+                        scintorArrayParam,
+                        checkOverlaps);
+
+  G4cout << "\n📋 Creat " << scintorArrayParam->GetNumberOfCubes()
+        << " Scintor Cube(" << num_z_layers << "  X " << num_phi << " )" << G4endl;
 
   G4VisAttributes* ScintorAttr = new G4VisAttributes(G4Colour::Green()); 
   ScintorAttr->SetForceSolid(true);  // 关键：强制以实体表面显示
   logicNaICube->SetVisAttributes(ScintorAttr);
 
+  fScintorLV = logicNaICube;
+  DefineRegions(logicXecylinder, logicNaICube);
+  WriteGdmlCache(physWorld);
   return physWorld;
 }
 
+G4VPhysicalVolume* DetectorConstruction::ReadGdmlCache()
+{
+  if (fGdmlCache.empty()) return 0;
+  std::ifstream cache(fGdmlCache.c_str());
+  if (!cache.good()) return 0;
+  // Written with the configuration it was built from, see WriteGdmlCache
+  std::ifstream keyFile((fGdmlCache + ".key").c_str());
+  std::ostringstream cachedKey;
+  cachedKey << keyFile.rdbuf();
+  if (!keyFile.good() || cachedKey.str() != GdmlCacheKey()) {
+    G4cout << fGdmlCache << " was built for another model or geometry,"
+           << " rebuilding it" << G4endl;
+    return 0;
+  }
+#ifdef G4LIB_USE_GDML
+  // Names are stripped of their pointer suffix on reading, so the
+  // sensitive volumes, regions and biasing find their volumes as usual
+  G4GDMLParser parser;
+  parser.Read(fGdmlCache, false);
+  G4VPhysicalVolume* world = parser.GetWorldVolume();
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  G4LogicalVolume* targetLV = store->GetVolume("logicXecylinder", false);
+  G4LogicalVolume* scintorLV = store->GetVolume("LogicScintor", false);
+  if (targetLV && scintorLV) DefineRegions(targetLV, scintorLV);
+  fScintorLV = scintorLV;
+  G4cout << "Geometry read from " << fGdmlCache << G4endl;
+  return world;
+#else
+  G4cout << "Geant4 built without GDML, " << fGdmlCache << " not read" << G4endl;
+  return 0;
+#endif
+}
+
+void DetectorConstruction::WriteGdmlCache(G4VPhysicalVolume* world)
+{
+  if (fGdmlCache.empty()) return;
+#ifdef G4LIB_USE_GDML
+  // With the pointer suffixes, so that solids of the same name (the
+  // boolean container) stay apart; they are stripped again on reading
+  std::remove(fGdmlCache.c_str());
+  G4GDMLParser parser;
+  parser.Write(fGdmlCache, world, true);
+  std::ofstream keyFile((fGdmlCache + ".key").c_str());
+  keyFile << GdmlCacheKey();
+  G4cout << "Geometry written to " << fGdmlCache << G4endl;
+#else
+  (void)world;
+  G4cout << "Geant4 built without GDML, " << fGdmlCache << " not written" << G4endl;
+#endif
+}
+
+G4String DetectorConstruction::GdmlCacheKey() const
+{
+  // Everything Construct depends on, in internal units
+  std::ostringstream key;
+  key.precision(17);
+  key << "model " << RunModel << "\n"
+      << "containerSolid " << fContainerSolid << "\n"
+      << "Xeradius " << Xeradius << "\n"
+      << "Xehalflength " << Xehalflength << "\n"
+      << "scintorDistance " << disctancefromXe << "\n"
+      << "scintorNPhi " << fScintorNPhi << "\n"
+      << "scintorNLayers " << fScintorNLayers << "\n"
+      << "scintorHalfSize " << fScintorHalfSize << "\n"
+      << "scintorLayerGap " << fScintorLayerGap << "\n";
+  return key.str();
+}
+
+void DetectorConstruction::ConstructSDandField()
+{
+  // Only steps inside these volumes reach user code; called once per
+  // thread, and again after a geometry rebuild
+  G4SDManager* sdManager = G4SDManager::GetSDMpointer();
+  for (const auto& sensitive : fSensitiveVolumes) {
+    G4String sdName = sensitive.first + "_SD";
+    G4VSensitiveDetector* sd = sdManager->FindSensitiveDetector(sdName, false);
+    if (!sd) {
+      sd = new RecordSD(sdName, RecordSD::FindTag(sensitive.second));
+      sdManager->AddNewDetector(sd);
+    }
+    SetSensitiveDetector(sensitive.first, sd, true);
+  }
+  ConstructBiasing();
+}
+
+void DetectorConstruction::ConstructBiasing()
+{
+  // Operators are per thread, like the sensitive detectors; a volume takes
+  // one operator only, so forced-collision volumes do not split.
+  // Geant4 cannot detach an operator, so each thread keeps the same two
+  // for its lifetime and attaches them to the volumes of every rebuild.
+  if (fForcedCollisionVolumes.empty() && fImportances.empty()) return;
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+
+  std::vector<G4LogicalVolume*> forced;
+  if (!fForcedCollisionVolumes.empty()) {
+    if (!fForceCollision) {
+      fForceCollision = new G4BOptrForceCollision("neutron", "ForceCollision");
+    }
+    for (const auto& name : fForcedCollisionVolumes) {
+      G4LogicalVolume* volume = store->GetVolume(name, false);
+      if (!volume) {
+        G4cout << "No logical volume " << name << ", no forced collisions"
+               << G4endl;
+        continue;
+      }
+      fForceCollision->AttachTo(volume);
+      forced.push_back(volume);
+    }
+  }
+
+  if (!fImportances.empty()) {
+    if (!fImportance) fImportance = new ImportanceBiasingOperator("neutron");
+    fImportance->ClearImportances();
+    for (const auto& entry : fImportances) {
+      G4LogicalVolume* volume = store->GetVolume(entry.first, false);
+      if (volume) fImportance->SetImportance(volume, entry.second);
+      else G4cout << "No logical volume " << entry.first << ", importance ignored"
+                  << G4endl;
+    }
+    for (G4LogicalVolume* volume : *store) {
+      if (std::find(forced.begin(), forced.end(), volume) == forced.end()) {
+        fImportance->AttachTo(volume);
+      }
+    }
+  }
+
+  // The volume-to-operator table of Geant4 keeps the entries of deleted
+  // volumes; a new volume reusing such an address must not be biased by
+  // the other operator
+  for (G4LogicalVolume* volume : *store) {
+    G4VBiasingOperator* expected = 0;
+    if (std::find(forced.begin(), forced.end(), volume) != forced.end()) {
+      expected = fForceCollision;
+    }
+    else if (!fImportances.empty()) {
+      expected = fImportance;
+    }
+    G4VBiasingOperator* current = G4VBiasingOperator::GetBiasingOperator(volume);
+    if (current != expected) {
+      G4ExceptionDescription description;
+      description << "Logical volume " << volume->GetName() << " is biased by "
+                  << (current ? current->GetName() : G4String("nothing"))
+                  << " from before a geometry rebuild; run this geometry"
+                  << " in a new job";
+      G4Exception("DetectorConstruction::ConstructBiasing()", "Bias002",
+                  FatalException, description);
+    }
+  }
+}
+
+void DetectorConstruction::DefineRegions(G4LogicalVolume* targetLV,
+                                         G4LogicalVolume* scintorLV)
+{
+  // A rebuild creates new logical volumes: the previous roots go first.
+  // Each region has a single root, which RemoveRootLogicalVolume does not
+  // touch, so this is safe even if the old volume was deleted.
+  G4RegionStore* store = G4RegionStore::GetInstance();
+  G4LogicalVolume* roots[2] = { targetLV, scintorLV };
+  for (G4int i = 0; i < 2; ++i) {
+    G4Region* region = store->FindOrCreateRegion(fRegions[i].name);
+    std::vector<G4LogicalVolume*> oldRoots(
+      region->GetRootLogicalVolumeIterator(),
+      region->GetRootLogicalVolumeIterator() + region->GetNumberOfRootVolumes());
+    for (G4LogicalVolume* old : oldRoots) {
+      region->RemoveRootLogicalVolume(old, false);
+    }
+    region->AddRootLogicalVolume(roots[i]);
+  }
+  fRegionsDefined = true;
+  ApplyRegionSettings();
+}
+
+void DetectorConstruction::ApplyRegionSettings()
+{
+  static const char* particles[4] = { "gamma", "e-", "e+", "proton" };
+  G4RegionStore* store = G4RegionStore::GetInstance();
+  for (auto& settings : fRegions) {
+    G4Region* region = store->GetRegion(settings.name, false);
+    if (!region) continue;
+
+    if (settings.cuts[0] > 0.) {
+      G4ProductionCuts* cuts = region->GetProductionCuts();
+      if (!cuts) {
+        cuts = new G4ProductionCuts();
+        region->SetProductionCuts(cuts);
+      }
+      for (G4int i = 0; i < 4; ++i) {
+        cuts->SetProductionCut(settings.cuts[i], particles[i]);
+      }
+    }
+
+    if (settings.maxStep > 0. || settings.maxTime > 0. ||
+        settings.minEkin > 0.) {
+      if (!settings.limits) settings.limits = new G4UserLimits();
+      settings.limits->SetMaxAllowedStep(settings.maxStep > 0. ? settings.maxStep
+                                                               : DBL_MAX);
+      settings.limits->SetUserMaxTime(settings.maxTime > 0. ? settings.maxTime
+                                                            : DBL_MAX);
+      settings.limits->SetUserMinEkine(settings.minEkin);
+      region->SetUserLimits(settings.limits);
+    }
+    else {
+      region->SetUserLimits(0);
+    }
+  }
+}
+
+DetectorConstruction::RegionSettings*
+DetectorConstruction::FindRegionSettings(const G4String& regionName)
+{
+  for (auto& settings : fRegions) {
+    if (settings.name == regionName) return &settings;
+  }
+  G4ExceptionDescription description;
+  description << "Unknown region " << regionName << ", use one of"
+              << " LXeTarget Scintillators DefaultRegionForTheWorld";
+  G4Exception("DetectorConstruction::FindRegionSettings()", "Region001",
+              JustWarning, description);
+  return 0;
+}
+
+void DetectorConstruction::SetRegionCut(const G4String& regionName,
+                                        const G4String& particle, G4double cut)
+{
+  RegionSettings* settings = FindRegionSettings(regionName);
+  if (!settings) return;
+  if (settings->cuts[0] < 0.) {
+    G4cout << "The cuts of " << regionName << " are set with /run/setCut"
+           << G4endl;
+    return;
+  }
+  static const char* particles[4] = { "gamma", "e-", "e+", "proton" };
+  for (G4int i = 0; i < 4; ++i) {
+    if (particle == "all" || particle == particles[i]) settings->cuts[i] = cut;
+  }
+  // Taken into account at the next BeamOn, like /run/setCutForRegion
+  if (fRegionsDefined) ApplyRegionSettings();
+}
+
+void DetectorConstruction::SetRegionLimit(const G4String& regionName,
+                                          const G4String& limit, G4double value)
+{
+  RegionSettings* settings = FindRegionSettings(regionName);
+  if (!settings) return;
+  if (limit == "maxStep") settings->maxStep = value;
+  if (limit == "maxTime") settings->maxTime = value;
+  if (limit == "minEkin") settings->minEkin = value;
+  if (fRegionsDefined) ApplyRegionSettings();
+}
+
+void DetectorConstruction::AddForcedCollision(const G4String& logicalName)
+{
+  fForcedCollisionVolumes.push_back(logicalName);
+}
+
+void DetectorConstruction::SetImportance(const G4String& logicalName,
+                                         G4double importance)
+{
+  for (auto& entry : fImportances) {
+    if (entry.first == logicalName) {
+      entry.second = importance;
+      return;
+    }
+  }
+  fImportances.push_back(std::make_pair(logicalName, importance));
+}
+
+void DetectorConstruction::AddSensitiveVolume(const G4String& logicalName,
+                                              const G4String& tag)
+{
+  fSensitiveVolumes.push_back(std::make_pair(logicalName, tag));
+}
+
+void DetectorConstruction::ClearSensitiveVolumes()
+{
+  fSensitiveVolumes.clear();
+}
+
+void DetectorConstruction::setXeradius(G4float value)
+{
+  if (value <= 0. || value + kTPCSideWall > kSSContainerInnerRadius) {
+    G4cout << "Xe radius " << value/cm << " cm does not fit in the container,"
+           << " ignored" << G4endl;
+    return;
+  }
+  Xeradius = value;
+  GeometryChanged();
+}
+
+void DetectorConstruction::setXehalflength(G4float value)
+{
+  if (value <= 0. || value + kTPCEndWall > kSSContainerHalfLength) {
+    G4cout << "Xe half length " << value/cm << " cm does not fit in the"
+           << " container, ignored" << G4endl;
+    return;
+  }
+  Xehalflength = value;
+  GeometryChanged();
+}
+
+void DetectorConstruction::setScintorDistance(G4float value)
+{
+  if (!ScintorArrayFits(fScintorNPhi, fScintorNLayers, fScintorHalfSize,
+                        value, fScintorLayerGap)) return;
+  disctancefromXe = value;
+  GeometryChanged();
+}
+
+void DetectorConstruction::setScintorNPhi(G4int value)
+{
+  if (!ScintorArrayFits(value, fScintorNLayers, fScintorHalfSize,
+                        disctancefromXe, fScintorLayerGap)) return;
+  fScintorNPhi = value;
+  GeometryChanged();
+}
+
+void DetectorConstruction::setScintorNLayers(G4int value)
+{
+  if (!ScintorArrayFits(fScintorNPhi, value, fScintorHalfSize,
+                        disctancefromXe, fScintorLayerGap)) return;
+  fScintorNLayers = value;
+  GeometryChanged();
+}
+
+void DetectorConstruction::setScintorHalfSize(G4float value)
+{
+  if (!ScintorArrayFits(fScintorNPhi, fScintorNLayers, value,
+                        disctancefromXe, fScintorLayerGap)) return;
+  fScintorHalfSize = value;
+  GeometryChanged();
+}
+
+void DetectorConstruction::setScintorLayerGap(G4float value)
+{
+  if (!ScintorArrayFits(fScintorNPhi, fScintorNLayers, fScintorHalfSize,
+                        disctancefromXe, value)) return;
+  fScintorLayerGap = value;
+  GeometryChanged();
+}
+
+void DetectorConstruction::ScintorArrayExtent(G4double& innerRadius,
+                                              G4double& outerRadius,
+                                              G4double& halfLength) const
+{
+  // Tube around the array: a cube corner reaches at most halfSize*sqrt(2)
+  // closer to or further from the axis than its centre
+  G4double corner = fScintorHalfSize*std::sqrt(2.);
+  innerRadius = disctancefromXe - corner;
+  outerRadius = disctancefromXe + corner;
+  halfLength = 0.5*(fScintorNLayers - 1)*(2*fScintorHalfSize + fScintorLayerGap)
+             + fScintorHalfSize;
+}
+
+G4bool DetectorConstruction::ScintorArrayFits(G4int nPhi, G4int nLayers,
+                                              G4double halfSize,
+                                              G4double radius,
+                                              G4double layerGap) const
+{
+  G4double corner = halfSize*std::sqrt(2.);
+  G4double halfLength = 0.5*(nLayers - 1)*(2*halfSize + layerGap) + halfSize;
+  // The flanges are only at the ends of the container
+  G4double containerRadius = halfLength > kSSContainerHalfLength ?
+    kSSContainerMaxRadius : kSSContainerOuterRadius;
+  G4String problem;
+  if (nPhi < 1 || nLayers < 1 || halfSize <= 0. || layerGap < 0.)
+    problem = "is empty";
+  else if (radius - corner <= containerRadius)
+    problem = "overlaps the container";
+  else if (nPhi > 1 && 2*radius*std::sin(pi/nPhi) < 2*corner)
+    problem = "has overlapping neighbour cubes";
+  else if (radius + corner > kWorldHalfXY ||
+           std::fabs(Xehalflength) + halfLength > kWorldHalfZ)
+    problem = "does not fit in the world";
+  if (problem.empty()) return true;
+  G4cout << "Scintor array of " << nLayers << " x " << nPhi << " cubes of half size "
+         << halfSize/cm << " cm at " << radius/cm << " cm (layer gap "
+         << layerGap/cm << " cm) " << problem << ", ignored" << G4endl;
+  return false;
+}
+
+void DetectorConstruction::SetContainerSolid(const G4String& style)
+{
+  if (style != "polycone" && style != "multiunion" && style != "boolean") {
+    G4cout << "Unknown container solid " << style << ", ignored" << G4endl;
+    return;
+  }
+  if (style == fContainerSolid) return;
+  fContainerSolid = style;
+  GeometryChanged();
+}
+
+void DetectorConstruction::BenchmarkNavigation(G4int nRays, G4long seed)
+{
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+    ->GetNavigatorForTracking()->GetWorldVolume();
+  if (!world || !fScintorLV) {
+    G4cout << "No geometry to benchmark, run /run/initialize first" << G4endl;
+    return;
+  }
+  // Rays start around the container and the scintillators, where the
+  // neutron histories are
+  G4double innerRadius, outerRadius, halfLength;
+  ScintorArrayExtent(innerRadius, outerRadius, halfLength);
+  G4double halfZ = std::max(halfLength,
+                            kSSContainerHalfLength + 2*kSSContainerFlangeHalfThickness);
+  G4cout << "Container solid: " << fContainerSolid << G4endl;
+  NavigationBenchmark benchmark(world, seed);
+  benchmark.Run(nRays, G4ThreeVector(0., 0., Xehalflength),
+                G4ThreeVector(outerRadius, outerRadius, halfZ));
+}
+
+void DetectorConstruction::setPb1Thickness(G4float value)
+{
+  Pb1thickness = value;
+  G4cout << "Pb1 thickness stored; the shield is not built by this geometry"
+         << G4endl;
+}
+
+void DetectorConstruction::setBPEThickness(G4float value)
+{
+  BPEthickness = value;
+  G4cout << "BPE thickness stored; the shield is not built by this geometry"
+         << G4endl;
+}
+
+void DetectorConstruction::setPb2Thickness(G4float value)
+{
+  Pb2thickness = value;
+  G4cout << "Pb2 thickness stored; the shield is not built by this geometry"
+         << G4endl;
+}
+
+void DetectorConstruction::setConstructFloor(G4bool value)
+{
+  ConstructFloor = value;
+  G4cout << "Floor flag stored; the floor is not built by this geometry"
+         << G4endl;
+}
+
+void DetectorConstruction::GeometryChanged()
+{
+  // A cached geometry no longer matches
+  if (!fGdmlCache.empty()) {
+    G4cout << "Geometry changed, " << fGdmlCache << " no longer used" << G4endl;
+    fGdmlCache = "";
+  }
+  if (!fScintorLV) return;  // not constructed yet
+
+  // Rebuilt at the next BeamOn; materials, regions, sensitive detectors
+  // and physics tables are reused
+  fScintorLV = 0;
+  G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
+
 void DetectorConstruction::ChooseModel(G4String value)
 {
+  // pos.mac chooses the default model after /run/initialize: no rebuild
+  if (value == RunModel) return;
   RunModel = value; 
-  G4RunManager::GetRunManager()->ReinitializeGeometry();
+  if (!fScintorLV) return;  // used by the first Construct
+
+  // Only the material changes: swap it in the existing logical volume and
+  // rebuild the physics tables, the geometry stays closed. A geometry from
+  // the GDML cache only holds the material of its own model.
+  G4Material* ScintorMaterial = G4Material::GetMaterial(RunModel, false);
+  if (!ScintorMaterial) {
+    DefineMaterial();
+    ScintorMaterial = (RunModel == "NaI") ? NaI : CsI;
+  }
+  fScintorLV->SetMaterial(ScintorMaterial);
+  G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+  G4cout << "Scintor material is now " << ScintorMaterial->GetName() << G4endl;
 }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
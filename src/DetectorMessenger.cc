@@ -1,6 +1,12 @@
 #include "DetectorMessenger.hh"
 #include "DetectorConstruction.hh"
 
+#include "G4UIparameter.hh"
+#include "G4UImanager.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include <sstream>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorMessenger::DetectorMessenger(DetectorConstruction * Det)
@@ -11,10 +17,165 @@ DetectorMessenger::DetectorMessenger(DetectorConstruction * Det)
 
   fRunModel = new G4UIcmdWithAString("/Runmodel/ModelChoose",this);
   fRunModel->SetGuidance("Choose a model to use.");
+  fRunModel->SetGuidance("Between runs only the scintillator material is");
+  fRunModel->SetGuidance("changed, so models can follow each other in one job.");
   fRunModel->SetParameterName("Model",false);
+  fRunModel->SetCandidates("NaI CsI");
   fRunModel->AvailableForStates(G4State_PreInit,G4State_Idle);
   fRunModel->SetDefaultValue("NaI");
 
+  fAddVolume = new G4UIcommand("/record/addVolume",this);
+  fAddVolume->SetGuidance("Record steps in a logical volume with a tag.");
+  G4UIparameter* volumeParam = new G4UIparameter("volume",'s',false);
+  fAddVolume->SetParameter(volumeParam);
+  G4UIparameter* tagParam = new G4UIparameter("tag",'s',true);
+  tagParam->SetParameterCandidates("default Xe scintor");
+  tagParam->SetDefaultValue("default");
+  fAddVolume->SetParameter(tagParam);
+  fAddVolume->SetGuidance("Sensitive detectors are attached on construction,");
+  fAddVolume->SetGuidance("so the volumes are set before /run/initialize.");
+  fAddVolume->AvailableForStates(G4State_PreInit);
+  fAddVolume->SetToBeBroadcasted(false);
+
+  fClearVolumes = new G4UIcmdWithoutParameter("/record/clearVolumes",this);
+  fClearVolumes->SetGuidance("Remove all sensitive volumes, including the");
+  fClearVolumes->SetGuidance("default Xe target and scintillator cubes.");
+  fClearVolumes->AvailableForStates(G4State_PreInit);
+  fClearVolumes->SetToBeBroadcasted(false);
+
+  fCheckOverlaps = new G4UIcmdWithABool("/Runmodel/checkOverlaps",this);
+  fCheckOverlaps->SetGuidance("Check the placements for overlaps on construction;");
+  fCheckOverlaps->SetGuidance("off by default in batch mode.");
+  fCheckOverlaps->SetParameterName("flag",true);
+  fCheckOverlaps->SetDefaultValue(true);
+  fCheckOverlaps->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fGdmlCache = new G4UIcmdWithAString("/Runmodel/gdmlCache",this);
+  fGdmlCache->SetGuidance("Read the geometry from this GDML file if it exists,");
+  fGdmlCache->SetGuidance("otherwise build it and write it there. A cache built");
+  fGdmlCache->SetGuidance("for another model or geometry (<file>.key) is rebuilt.");
+  fGdmlCache->SetParameterName("fileName",false);
+  fGdmlCache->AvailableForStates(G4State_PreInit);
+
+  // Geometry parameters; between runs the geometry is rebuilt in place,
+  // see also /scan/run
+  fXeRadius = NewLengthCommand("/Runmodel/setXeradius",
+                               "Radius of the LXe cylinder.");
+  fXeHalfLength = NewLengthCommand("/Runmodel/setXehalflength",
+                                   "Half length of the LXe cylinder.");
+  fScintorDistance = NewLengthCommand("/Runmodel/setScintorDistance",
+                                      "Distance of the scintillator cube centres from the axis.");
+  fPb1Thickness = NewLengthCommand("/Runmodel/setPb1Thickness",
+                                   "Inner lead shield thickness (shielded models only).");
+  fBPEThickness = NewLengthCommand("/Runmodel/setBPEThickness",
+                                   "Borated PE shield thickness (shielded models only).");
+  fPb2Thickness = NewLengthCommand("/Runmodel/setPb2Thickness",
+                                   "Outer lead shield thickness (shielded models only).");
+
+  fScintorDir = new G4UIdirectory("/Runmodel/scintor/");
+  fScintorDir->SetGuidance("Scintillator cube array: layers of cubes on a ring");
+  fScintorDir->SetGuidance("around the container, centred on it. The ring radius");
+  fScintorDir->SetGuidance("is set by /Runmodel/setScintorDistance.");
+  fScintorNPhi = NewCountCommand("/Runmodel/scintor/nPhi",
+                                 "Number of cubes around the ring.");
+  fScintorNLayers = NewCountCommand("/Runmodel/scintor/nLayers",
+                                    "Number of layers along the axis.");
+  fScintorHalfSize = NewLengthCommand("/Runmodel/scintor/halfSize",
+                                      "Half edge of a cube.");
+  fScintorLayerGap = NewLengthCommand("/Runmodel/scintor/layerGap",
+                                      "Gap between two layers.");
+
+  fContainerSolid = new G4UIcmdWithAString("/Runmodel/containerSolid",this);
+  fContainerSolid->SetGuidance("Solid of the SS container with its flanges: the");
+  fContainerSolid->SetGuidance("same shape as a polycone, a G4MultiUnion or the");
+  fContainerSolid->SetGuidance("former chain of G4UnionSolids.");
+  fContainerSolid->SetParameterName("style",false);
+  fContainerSolid->SetCandidates("polycone multiunion boolean");
+  fContainerSolid->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fContainerSolid->SetToBeBroadcasted(false);
+
+  fBenchmarkNavigation = new G4UIcommand("/Runmodel/benchmarkNavigation",this);
+  fBenchmarkNavigation->SetGuidance("Time straight rays through the geometry, from");
+  fBenchmarkNavigation->SetGuidance("random points around the container. The same");
+  fBenchmarkNavigation->SetGuidance("seed gives the same rays, see marcos/navbench.mac.");
+  G4UIparameter* raysParam = new G4UIparameter("nRays",'i',true);
+  raysParam->SetDefaultValue(100000);
+  raysParam->SetParameterRange("nRays>0");
+  fBenchmarkNavigation->SetParameter(raysParam);
+  G4UIparameter* raySeedParam = new G4UIparameter("seed",'i',true);
+  raySeedParam->SetDefaultValue(12345);
+  fBenchmarkNavigation->SetParameter(raySeedParam);
+  fBenchmarkNavigation->AvailableForStates(G4State_Idle);
+  fBenchmarkNavigation->SetToBeBroadcasted(false);
+
+  fConstructFloor = new G4UIcmdWithABool("/Runmodel/setConstructFloor",this);
+  fConstructFloor->SetGuidance("Build the floor (shielded models only).");
+  fConstructFloor->SetParameterName("flag",true);
+  fConstructFloor->SetDefaultValue(true);
+  fConstructFloor->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fConstructFloor->SetToBeBroadcasted(false);
+
+  fBiasDir = new G4UIdirectory("/Runmodel/bias/");
+  fBiasDir->SetGuidance("Neutron variance reduction; recorded steps carry the");
+  fBiasDir->SetGuidance("statistical weight in the weight column.");
+
+  fForceCollision = new G4UIcmdWithAString("/Runmodel/bias/forceCollision",this);
+  fForceCollision->SetGuidance("Force one neutron interaction in every crossing");
+  fForceCollision->SetGuidance("of a logical volume.");
+  fForceCollision->SetParameterName("volume",true);
+  fForceCollision->SetDefaultValue("logicXecylinder");
+  fForceCollision->AvailableForStates(G4State_PreInit);
+
+  fImportance = new G4UIcommand("/Runmodel/bias/importance",this);
+  fImportance->SetGuidance("Importance of a logical volume (default 1): neutrons");
+  fImportance->SetGuidance("are split entering a more important volume, and");
+  fImportance->SetGuidance("play Russian roulette entering a less important one.");
+  G4UIparameter* importanceVolumeParam = new G4UIparameter("volume",'s',false);
+  fImportance->SetParameter(importanceVolumeParam);
+  G4UIparameter* importanceParam = new G4UIparameter("importance",'d',false);
+  importanceParam->SetParameterRange("importance>0.");
+  fImportance->SetParameter(importanceParam);
+  fImportance->AvailableForStates(G4State_PreInit);
+
+  fRegionDir = new G4UIdirectory("/Runmodel/region/");
+  fRegionDir->SetGuidance("Production cuts and user limits of the regions");
+  fRegionDir->SetGuidance("LXeTarget, Scintillators and DefaultRegionForTheWorld.");
+
+  fRegionCut = new G4UIcommand("/Runmodel/region/setCut",this);
+  fRegionCut->SetGuidance("Production cut of a region, for one particle or all.");
+  fRegionCut->SetGuidance("The world cuts are set with /run/setCut.");
+  G4UIparameter* cutRegionParam = new G4UIparameter("region",'s',false);
+  cutRegionParam->SetParameterCandidates("LXeTarget Scintillators");
+  fRegionCut->SetParameter(cutRegionParam);
+  G4UIparameter* cutParam = new G4UIparameter("cut",'d',false);
+  cutParam->SetParameterRange("cut>0.");
+  fRegionCut->SetParameter(cutParam);
+  G4UIparameter* cutUnitParam = new G4UIparameter("unit",'s',true);
+  cutUnitParam->SetDefaultValue("mm");
+  fRegionCut->SetParameter(cutUnitParam);
+  G4UIparameter* cutParticleParam = new G4UIparameter("particle",'s',true);
+  cutParticleParam->SetParameterCandidates("all gamma e- e+ proton");
+  cutParticleParam->SetDefaultValue("all");
+  fRegionCut->SetParameter(cutParticleParam);
+  fRegionCut->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRegionLimit = new G4UIcommand("/Runmodel/region/setLimit",this);
+  fRegionLimit->SetGuidance("User limit of a region, 0 removes it:");
+  fRegionLimit->SetGuidance("maxStep (length), maxTime (global time) or");
+  fRegionLimit->SetGuidance("minEkin (tracks below are killed).");
+  G4UIparameter* limitRegionParam = new G4UIparameter("region",'s',false);
+  limitRegionParam->SetParameterCandidates(
+    "LXeTarget Scintillators DefaultRegionForTheWorld");
+  fRegionLimit->SetParameter(limitRegionParam);
+  G4UIparameter* limitParam = new G4UIparameter("limit",'s',false);
+  limitParam->SetParameterCandidates("maxStep maxTime minEkin");
+  fRegionLimit->SetParameter(limitParam);
+  G4UIparameter* limitValueParam = new G4UIparameter("value",'d',false);
+  limitValueParam->SetParameterRange("value>=0.");
+  fRegionLimit->SetParameter(limitValueParam);
+  G4UIparameter* limitUnitParam = new G4UIparameter("unit",'s',false);
+  fRegionLimit->SetParameter(limitUnitParam);
+  fRegionLimit->AvailableForStates(G4State_PreInit,G4State_Idle);
 
 }
 
@@ -24,6 +185,61 @@ DetectorMessenger::~DetectorMessenger()
 {
   delete fRunparameter;
   delete fRunModel;
+  delete fAddVolume;
+  delete fClearVolumes;
+  delete fCheckOverlaps;
+  delete fGdmlCache;
+  delete fXeRadius;
+  delete fXeHalfLength;
+  delete fScintorDistance;
+  delete fPb1Thickness;
+  delete fBPEThickness;
+  delete fPb2Thickness;
+  delete fConstructFloor;
+  delete fContainerSolid;
+  delete fBenchmarkNavigation;
+  delete fScintorNPhi;
+  delete fScintorNLayers;
+  delete fScintorHalfSize;
+  delete fScintorLayerGap;
+  delete fScintorDir;
+  delete fForceCollision;
+  delete fImportance;
+  delete fBiasDir;
+  delete fRegionCut;
+  delete fRegionLimit;
+  delete fRegionDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4UIcmdWithADoubleAndUnit* DetectorMessenger::NewLengthCommand(const char* path,
+                                                               const char* guidance)
+{
+  G4UIcmdWithADoubleAndUnit* command = new G4UIcmdWithADoubleAndUnit(path,this);
+  command->SetGuidance(guidance);
+  command->SetParameterName("length",false);
+  command->SetRange("length>=0.");
+  command->SetUnitCategory("Length");
+  command->SetDefaultUnit("cm");
+  command->AvailableForStates(G4State_PreInit,G4State_Idle);
+  // The detector construction only exists on the master thread
+  command->SetToBeBroadcasted(false);
+  return command;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4UIcmdWithAnInteger* DetectorMessenger::NewCountCommand(const char* path,
+                                                         const char* guidance)
+{
+  G4UIcmdWithAnInteger* command = new G4UIcmdWithAnInteger(path,this);
+  command->SetGuidance(guidance);
+  command->SetParameterName("count",false);
+  command->SetRange("count>=1");
+  command->AvailableForStates(G4State_PreInit,G4State_Idle);
+  command->SetToBeBroadcasted(false);
+  return command;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -34,5 +250,113 @@ void DetectorMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
   {
     fDetector->ChooseModel(newValue);
   }
+  if( command == fAddVolume )
+  {
+    G4String volume, tag;
+    std::istringstream is(newValue);
+    is >> volume >> tag;
+    fDetector->AddSensitiveVolume(volume, tag);
+  }
+  if( command == fClearVolumes )
+  {
+    fDetector->ClearSensitiveVolumes();
+  }
+  if( command == fXeRadius )
+  {
+    fDetector->setXeradius(fXeRadius->GetNewDoubleValue(newValue));
+  }
+  if( command == fXeHalfLength )
+  {
+    fDetector->setXehalflength(fXeHalfLength->GetNewDoubleValue(newValue));
+  }
+  if( command == fScintorDistance )
+  {
+    fDetector->setScintorDistance(fScintorDistance->GetNewDoubleValue(newValue));
+  }
+  if( command == fScintorNPhi )
+  {
+    fDetector->setScintorNPhi(fScintorNPhi->GetNewIntValue(newValue));
+  }
+  if( command == fScintorNLayers )
+  {
+    fDetector->setScintorNLayers(fScintorNLayers->GetNewIntValue(newValue));
+  }
+  if( command == fScintorHalfSize )
+  {
+    fDetector->setScintorHalfSize(fScintorHalfSize->GetNewDoubleValue(newValue));
+  }
+  if( command == fScintorLayerGap )
+  {
+    fDetector->setScintorLayerGap(fScintorLayerGap->GetNewDoubleValue(newValue));
+  }
+  if( command == fPb1Thickness )
+  {
+    fDetector->setPb1Thickness(fPb1Thickness->GetNewDoubleValue(newValue));
+  }
+  if( command == fBPEThickness )
+  {
+    fDetector->setBPEThickness(fBPEThickness->GetNewDoubleValue(newValue));
+  }
+  if( command == fPb2Thickness )
+  {
+    fDetector->setPb2Thickness(fPb2Thickness->GetNewDoubleValue(newValue));
+  }
+  if( command == fConstructFloor )
+  {
+    fDetector->setConstructFloor(fConstructFloor->GetNewBoolValue(newValue));
+  }
+  if( command == fContainerSolid )
+  {
+    fDetector->SetContainerSolid(newValue);
+  }
+  if( command == fBenchmarkNavigation )
+  {
+    G4int nRays = 100000;
+    G4long seed = 12345;
+    std::istringstream is(newValue);
+    is >> nRays >> seed;
+    fDetector->BenchmarkNavigation(nRays, seed);
+  }
+  if( command == fCheckOverlaps )
+  {
+    fDetector->SetCheckOverlaps(fCheckOverlaps->GetNewBoolValue(newValue));
+  }
+  if( command == fGdmlCache )
+  {
+    fDetector->SetGdmlCache(newValue);
+  }
+  if( command == fForceCollision || command == fImportance )
+  {
+    // The operators only act on particles with biasing processes
+    G4UImanager::GetUIpointer()->ApplyCommand("/physics/biasing neutron");
+  }
+  if( command == fForceCollision )
+  {
+    fDetector->AddForcedCollision(newValue);
+  }
+  if( command == fImportance )
+  {
+    G4String volume;
+    G4double importance = 1.;
+    std::istringstream is(newValue);
+    is >> volume >> importance;
+    fDetector->SetImportance(volume, importance);
+  }
+  if( command == fRegionCut )
+  {
+    G4String region, unit, particle;
+    G4double cut = 0.;
+    std::istringstream is(newValue);
+    is >> region >> cut >> unit >> particle;
+    fDetector->SetRegionCut(region, particle, cut*G4UIcommand::ValueOf(unit));
+  }
+  if( command == fRegionLimit )
+  {
+    G4String region, limit, unit;
+    G4double value = 0.;
+    std::istringstream is(newValue);
+    is >> region >> limit >> value >> unit;
+    fDetector->SetRegionLimit(region, limit, value*G4UIcommand::ValueOf(unit));
+  }
 }
 
@@ -0,0 +1,151 @@
+/// \file EnergySpectrum.cc
+/// \brief Implementation of the EnergySpectrum class
+
+#include "EnergySpectrum.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EnergySpectrum::EnergySpectrum()
+: fHistogram(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EnergySpectrum::~EnergySpectrum()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EnergySpectrum::Clear()
+{
+  fEnergies.clear();
+  fYields.clear();
+  fProbability.clear();
+  fAlias.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EnergySpectrum::Load(const G4String& fileName, G4bool histogram)
+{
+  G4ExceptionDescription description;
+  std::ifstream in(fileName.c_str());
+  std::vector<G4double> energies;
+  std::vector<G4double> yields;
+  std::string line;
+  G4int lineNumber = 0;
+  while (in && std::getline(in, line)) {
+    ++lineNumber;
+    line = line.substr(0, line.find('#'));
+    std::istringstream is(line);
+    G4double energy, yield;
+    if (!(is >> energy)) continue;   // blank line
+    if (!(is >> yield) || yield < 0. ||
+        (!energies.empty() && energy <= energies.back())) {
+      description << fileName << " line " << lineNumber
+                  << ": expected increasing energy and a yield >= 0";
+      break;
+    }
+    energies.push_back(energy*MeV);
+    yields.push_back(yield);
+  }
+  if (!in.is_open()) description << "Cannot open spectrum " << fileName;
+  else if (description.str().empty() && energies.size() < 2) {
+    description << fileName << ": a spectrum needs at least two points";
+  }
+
+  // Probability of every interval between two points
+  std::vector<G4double> weights;
+  G4double total = 0.;
+  for (std::size_t i = 0; description.str().empty() && i + 1 < energies.size(); ++i) {
+    G4double width = energies[i+1] - energies[i];
+    G4double weight = histogram ? yields[i]*width
+                                : 0.5*(yields[i] + yields[i+1])*width;
+    weights.push_back(weight);
+    total += weight;
+  }
+  if (description.str().empty() && total <= 0.) {
+    description << fileName << ": all yields are zero";
+  }
+  if (!description.str().empty()) {
+    G4Exception("EnergySpectrum::Load()", "Source001", JustWarning, description);
+    return false;
+  }
+
+  fHistogram = histogram;
+  fEnergies.swap(energies);
+  fYields.swap(yields);
+  BuildAliasTable(weights);
+  G4cout << "Energy spectrum " << fileName << ": " << fEnergies.size()
+         << " points, " << fEnergies.front()/MeV << " - "
+         << fEnergies.back()/MeV << " MeV" << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EnergySpectrum::BuildAliasTable(const std::vector<G4double>& weights)
+{
+  // Vose: scaled probabilities below 1 are topped up by one interval above
+  G4int n = G4int(weights.size());
+  G4double total = 0.;
+  for (G4double weight : weights) total += weight;
+  std::vector<G4double> scaled(n);
+  std::vector<G4int> small, large;
+  for (G4int i = 0; i < n; ++i) {
+    scaled[i] = weights[i]*n/total;
+    if (scaled[i] < 1.) small.push_back(i);
+    else large.push_back(i);
+  }
+  fProbability.assign(n, 1.);
+  fAlias.resize(n);
+  for (G4int i = 0; i < n; ++i) fAlias[i] = i;
+  while (!small.empty() && !large.empty()) {
+    G4int less = small.back();
+    small.pop_back();
+    G4int more = large.back();
+    fProbability[less] = scaled[less];
+    fAlias[less] = more;
+    scaled[more] -= 1. - scaled[less];
+    if (scaled[more] < 1.) {
+      large.pop_back();
+      small.push_back(more);
+    }
+  }
+  // Whatever is left is 1 up to rounding
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EnergySpectrum::Sample() const
+{
+  G4int n = G4int(fProbability.size());
+  G4double u = G4UniformRand()*n;
+  G4int i = std::min(G4int(u), n - 1);
+  if (u - i >= fProbability[i]) i = fAlias[i];
+
+  G4double low = fEnergies[i];
+  G4double width = fEnergies[i+1] - low;
+  G4double r = G4UniformRand();
+  if (fHistogram) return low + r*width;
+
+  // Linear density y0 -> y1 over the interval, inverse of its CDF
+  G4double y0 = fYields[i];
+  G4double y1 = fYields[i+1];
+  G4double t = r;
+  if (std::fabs(y1 - y0) > 1e-9*(y0 + y1)) {
+    t = (std::sqrt(y0*y0 + r*(y1*y1 - y0*y0)) - y0)/(y1 - y0);
+  }
+  return low + t*width;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
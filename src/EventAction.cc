@@ -2,35 +2,379 @@
 /// \brief Implementation of the EventAction class
 
 #include "EventAction.hh"
+#include "EventMessenger.hh"
 #include "RunAction.hh"
+#include "RecordSD.hh"
+#include "StepHit.hh"
+#include "ProcessIDTable.hh"
+#include "AsyncStepWriter.hh"
+#include "StepRecord.hh"
+#include "ProgressReporter.hh"
+#include "SeedManager.hh"
+#include "PhaseSpaceRecorder.hh"
 
 #include "G4Event.hh"
+#include "G4HCofThisEvent.hh"
+#include "G4ParticleDefinition.hh"
 #include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4SDManager.hh"
+#include "G4HCtable.hh"
+#include "g4root.hh"
+
+#include <cstring>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EventAction::EventAction(RunAction* runAction)
-{} 
+: G4UserEventAction(),
+  fRunAction(runAction),
+  fMessenger(0),
+  fRecordMode(kRecordSteps),
+  fHitsPerTrack(true),
+  fTriggerEnabled(false),
+  fXeThreshold(0.),
+  fScintorThreshold(0.),
+  fCoincidenceWindow(0.),
+  fEarlyAbort(kAbortNever),
+  fPrimaryInXe(false),
+  fAbortedEarly(false),
+  fNSteps(0),
+  fCollectionsRunID(-1)
+{
+  fHits.reserve(64);
+  fTriggerSums.reserve(64);
+  fMessenger = new EventMessenger(this);
+} 
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EventAction::~EventAction()
-{}
+{
+  delete fMessenger;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EventAction::BeginOfEventAction(const G4Event* pEvent)
+void EventAction::BeginOfEventAction(const G4Event*)
 {    
-  if (pEvent->GetEventID() % 10000 == 0) {
-    G4cout << "------ Begin event " << pEvent->GetEventID() << " ------"
-           << G4endl;
+  // Progress is reported by time, see ProgressReporter
+  G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+  if (runID != fCollectionsRunID) FindStepCollections(runID);
+  fHits.clear();
+  fPrimaryInXe = false;
+  fAbortedEarly = false;
+  fNSteps = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::FindStepCollections(G4int runID)
+{
+  // Only the collections of a RecordSD hold StepHits; the sensitive
+  // volumes are fixed before the first run, so this is done once per run
+  fStepCollections.clear();
+  G4SDManager* sdManager = G4SDManager::GetSDMpointer();
+  G4HCtable* table = sdManager->GetHCtable();
+  for (G4int i = 0; i < table->entries(); ++i) {
+    G4String sdName = table->GetSDname(i);
+    G4String hcName = table->GetHCname(i);
+    if (hcName != RecordSD::GetCollectionName()) continue;
+    if (!dynamic_cast<RecordSD*>(sdManager->FindSensitiveDetector(sdName, false))) {
+      continue;
+    }
+    fStepCollections.push_back(sdManager->GetCollectionID(sdName + "/" + hcName));
   }
+  fCollectionsRunID = runID;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EventAction::EndOfEventAction(const G4Event*)
+void EventAction::EndOfEventAction(const G4Event* pEvent)
 {   
+  fRunAction->CountSteps(fNSteps);
+  G4long nRecords = 0;
+  WriteEvent(pEvent, nRecords);
+  ProgressReporter::Instance()->EventDone(fNSteps, nRecords);
+  PhaseSpaceRecorder* phaseSpace = PhaseSpaceRecorder::Instance();
+  if (phaseSpace->IsActive()) phaseSpace->EndEvent();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::WriteEvent(const G4Event* pEvent, G4long& nRecords)
+{
+  G4HCofThisEvent* hce = pEvent->GetHCofThisEvent();
+  if (!hce) return;
+
+  if (fTriggerEnabled) {
+    G4bool accepted = !fAbortedEarly && PassesTrigger(hce);
+    fRunAction->CountTrigger(accepted, fAbortedEarly);
+    if (!accepted) return;
+  }
+
+  // Continues across the segments of a checkpointed run
+  G4int eventID = SeedManager::GetEventID(pEvent->GetEventID());
+  G4bool coded = (fRunAction->GetEncoding() == kEncodeCodes);
+  G4bool binary = (fRunAction->GetFormat() == kFormatBinary);
+
+  // Binary format: the whole event goes into one reserved block
+  char* record = 0;
+  if ((fRecordMode & kRecordSteps) && binary) {
+    G4int nSteps = 0;
+    for (G4int id : fStepCollections) {
+      if (hce->GetHC(id)) nSteps += G4int(hce->GetHC(id)->GetSize());
+    }
+    if (nSteps > 0) {
+      char* block = AsyncStepWriter::Instance()->Reserve(
+        sizeof(StepEventHeader) + nSteps * sizeof(StepRecord));
+      StepEventHeader header = { eventID, nSteps };
+      std::memcpy(block, &header, sizeof(header));
+      record = block + sizeof(header);
+    }
+  }
+
+  for (G4int id : fStepCollections) {
+    auto steps = static_cast<StepHitsCollection*>(hce->GetHC(id));
+    if (!steps) continue;
+    for (std::size_t j = 0; j < steps->entries(); ++j) {
+      const StepHit* step = (*steps)[j];
+      if (fRecordMode & kRecordSteps) {
+        ++nRecords;
+        if (binary) {
+          FillStepRecord(record, step);
+          record += sizeof(StepRecord);
+        }
+        else if (coded) FillStepCodeRow(eventID, step);
+        else FillStepRow(eventID, step);
+      }
+      if (fRecordMode & kRecordHits) AddDeposit(step);
+    }
+  }
+  if (fRecordMode & kRecordHits) {
+    FillHitRows(eventID);
+    nRecords += fHits.size();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::SumTriggerDeposits(G4HCofThisEvent* hce)
+{
+  // Sum the deposits per volume copy; the Xe target is one copy (-1)
+  fTriggerSums.clear();
+  for (G4int id : fStepCollections) {
+    auto steps = static_cast<StepHitsCollection*>(hce->GetHC(id));
+    if (!steps) continue;
+    for (std::size_t j = 0; j < steps->entries(); ++j) {
+      const StepHit* step = (*steps)[j];
+      if (step->fEdep <= 0.) continue;
+      if (step->fTag != kTagXe && step->fTag != kTagScintor) continue;
+      WarnWeightedTrigger(step->fWeight);
+      VolumeHit* sum = 0;
+      for (auto& candidate : fTriggerSums) {
+        if (candidate.tag == step->fTag && candidate.copyNo == step->fCopyNo) {
+          sum = &candidate;
+          break;
+        }
+      }
+      if (!sum) {
+        VolumeHit empty = { step->fTag, step->fCopyNo, -1, 0, 0, 0.,
+                            G4ThreeVector(), step->fTime };
+        fTriggerSums.push_back(empty);
+        sum = &fTriggerSums.back();
+      }
+      sum->edep += step->fEdep;
+      if (step->fTime < sum->firstTime) sum->firstTime = step->fTime;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::WarnWeightedTrigger(G4double weight)
+{
+  // A threshold is not linear in the deposits: the trigger of a split or
+  // forced-collision event is not that of the unbiased event
+  static G4ThreadLocal G4bool warned = false;
+  if (weight == 1. || warned) return;
+  warned = true;
+  G4Exception("EventAction::SumTriggerDeposits()", "Trigger001", JustWarning,
+              "Weighted tracks (/Runmodel/bias/) reach the coincidence trigger;"
+              " triggered output is biased, run without biasing for it");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventAction::PassesTrigger(G4HCofThisEvent* hce)
+{
+  SumTriggerDeposits(hce);
+
+  const VolumeHit* xe = 0;
+  for (const auto& sum : fTriggerSums) {
+    if (sum.tag == kTagXe && sum.edep > fXeThreshold) xe = &sum;
+  }
+  if (!xe) return false;
+
+  for (const auto& sum : fTriggerSums) {
+    if (sum.tag != kTagScintor || sum.edep <= fScintorThreshold) continue;
+    G4double delay = sum.firstTime - xe->firstTime;
+    if (fCoincidenceWindow <= 0. ||
+        (delay >= 0. && delay <= fCoincidenceWindow)) return true;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EventAction::CanStillTrigger(G4HCofThisEvent* hce,
+                                    G4double pendingEnergy)
+{
+  // Upper bound, ignoring the time window: all the pending energy could
+  // still end up in the Xe target and in the best scintillator copy
+  G4double xeEdep = 0.;
+  G4double scintorEdep = 0.;
+  if (hce) {
+    SumTriggerDeposits(hce);
+    for (const auto& sum : fTriggerSums) {
+      if (sum.tag == kTagXe) xeEdep = sum.edep;
+      else if (sum.edep > scintorEdep) scintorEdep = sum.edep;
+    }
+  }
+  return xeEdep + pendingEnergy > fXeThreshold &&
+         scintorEdep + pendingEnergy > fScintorThreshold;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::FillStepRow(G4int eventID, const StepHit* step)
+{
+  const ProcessIDTable* processTable = ProcessIDTable::Instance();
+  auto analysisManager = G4AnalysisManager::Instance();
+  analysisManager->FillNtupleDColumn(kStepNtuple, 0, step->fEnergy);
+  analysisManager->FillNtupleDColumn(kStepNtuple, 1, G4float(step->fPrePos.x()));
+  analysisManager->FillNtupleDColumn(kStepNtuple, 2, G4float(step->fPrePos.y()));
+  analysisManager->FillNtupleDColumn(kStepNtuple, 3, G4float(step->fPrePos.z()));
+  analysisManager->FillNtupleDColumn(kStepNtuple, 4, G4float(step->fPostPos.x()));
+  analysisManager->FillNtupleDColumn(kStepNtuple, 5, G4float(step->fPostPos.y()));
+  analysisManager->FillNtupleDColumn(kStepNtuple, 6, G4float(step->fPostPos.z()));
+  analysisManager->FillNtupleSColumn(kStepNtuple, 7, step->fParticle->GetParticleName());
+  analysisManager->FillNtupleIColumn(kStepNtuple, 8, eventID);
+  analysisManager->FillNtupleIColumn(kStepNtuple, 9, step->fTrackID);
+  analysisManager->FillNtupleIColumn(kStepNtuple, 10, step->fParentID);
+  analysisManager->FillNtupleDColumn(kStepNtuple, 11, step->fEdep);
+  analysisManager->FillNtupleSColumn(kStepNtuple, 12,
+                                     processTable->GetName(step->fCreatProcessID));
+  analysisManager->FillNtupleSColumn(kStepNtuple, 13,
+                                     processTable->GetName(step->fEndProcessID));
+  analysisManager->FillNtupleSColumn(kStepNtuple, 14, RecordSD::GetTagName(step->fTag));
+  analysisManager->FillNtupleIColumn(kStepNtuple, 15, step->fCopyNo);
+  analysisManager->FillNtupleDColumn(kStepNtuple, 16, G4float(step->fTime));
+  analysisManager->FillNtupleDColumn(kStepNtuple, 17, step->fWeight);
+  analysisManager->AddNtupleRow(kStepNtuple);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::FillStepCodeRow(G4int eventID, const StepHit* step)
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+  analysisManager->FillNtupleDColumn(kStepCodeNtuple, 0, step->fEnergy);
+  analysisManager->FillNtupleFColumn(kStepCodeNtuple, 1, step->fPrePos.x());
+  analysisManager->FillNtupleFColumn(kStepCodeNtuple, 2, step->fPrePos.y());
+  analysisManager->FillNtupleFColumn(kStepCodeNtuple, 3, step->fPrePos.z());
+  analysisManager->FillNtupleFColumn(kStepCodeNtuple, 4, step->fPostPos.x());
+  analysisManager->FillNtupleFColumn(kStepCodeNtuple, 5, step->fPostPos.y());
+  analysisManager->FillNtupleFColumn(kStepCodeNtuple, 6, step->fPostPos.z());
+  analysisManager->FillNtupleIColumn(kStepCodeNtuple, 7, step->fParticle->GetPDGEncoding());
+  analysisManager->FillNtupleIColumn(kStepCodeNtuple, 8, eventID);
+  analysisManager->FillNtupleIColumn(kStepCodeNtuple, 9, step->fTrackID);
+  analysisManager->FillNtupleIColumn(kStepCodeNtuple, 10, step->fParentID);
+  analysisManager->FillNtupleDColumn(kStepCodeNtuple, 11, step->fEdep);
+  analysisManager->FillNtupleIColumn(kStepCodeNtuple, 12, step->fCreatProcessID);
+  analysisManager->FillNtupleIColumn(kStepCodeNtuple, 13, step->fEndProcessID);
+  analysisManager->FillNtupleIColumn(kStepCodeNtuple, 14, step->fTag);
+  analysisManager->FillNtupleIColumn(kStepCodeNtuple, 15, step->fCopyNo);
+  analysisManager->FillNtupleFColumn(kStepCodeNtuple, 16, step->fTime);
+  analysisManager->FillNtupleDColumn(kStepCodeNtuple, 17, step->fWeight);
+  analysisManager->AddNtupleRow(kStepCodeNtuple);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::FillStepRecord(char* record, const StepHit* step)
+{
+  // The block is not aligned for StepRecord, hence the memcpy
+  StepRecord packed;
+  packed.energy = step->fEnergy;
+  packed.dE = step->fEdep;
+  packed.pre[0] = step->fPrePos.x();
+  packed.pre[1] = step->fPrePos.y();
+  packed.pre[2] = step->fPrePos.z();
+  packed.post[0] = step->fPostPos.x();
+  packed.post[1] = step->fPostPos.y();
+  packed.post[2] = step->fPostPos.z();
+  packed.time = step->fTime;
+  packed.pdg = step->fParticle->GetPDGEncoding();
+  packed.trackID = step->fTrackID;
+  packed.parentID = step->fParentID;
+  packed.copyNo = step->fCopyNo;
+  packed.creatProcessID = std::uint16_t(step->fCreatProcessID);
+  packed.endProcessID = std::uint16_t(step->fEndProcessID);
+  packed.tag = std::uint16_t(step->fTag);
+  packed.flags = 0;
+  packed.weight = step->fWeight;
+  std::memcpy(record, &packed, sizeof(packed));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::AddDeposit(const StepHit* step)
+{
+  if (step->fEdep <= 0.) return;
+  G4int trackID = fHitsPerTrack ? step->fTrackID : -1;
+  G4ThreeVector position = 0.5 * (step->fPrePos + step->fPostPos);
+
+  // A handful of hits per event: a linear scan beats any map here
+  for (auto& hit : fHits) {
+    if (hit.tag == step->fTag && hit.copyNo == step->fCopyNo &&
+        hit.trackID == trackID) {
+      hit.edep += step->fEdep;
+      hit.weightedPos += step->fEdep * position;
+      hit.weightedEdep += step->fWeight * step->fEdep;
+      if (step->fTime < hit.firstTime) hit.firstTime = step->fTime;
+      ++hit.nSteps;
+      return;
+    }
+  }
+  G4int pdg = fHitsPerTrack ? step->fParticle->GetPDGEncoding() : 0;
+  VolumeHit hit = { step->fTag, step->fCopyNo, trackID, pdg, 1,
+                    step->fEdep, step->fEdep * position, step->fTime,
+                    step->fWeight * step->fEdep };
+  fHits.push_back(hit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventAction::FillHitRows(G4int eventID)
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+  for (const auto& hit : fHits) {
+    G4ThreeVector position = hit.weightedPos / hit.edep;
+    analysisManager->FillNtupleIColumn(kHitNtuple, 0, eventID);
+    analysisManager->FillNtupleSColumn(kHitNtuple, 1, RecordSD::GetTagName(hit.tag));
+    analysisManager->FillNtupleIColumn(kHitNtuple, 2, hit.copyNo);
+    analysisManager->FillNtupleIColumn(kHitNtuple, 3, hit.trackID);
+    analysisManager->FillNtupleIColumn(kHitNtuple, 4, hit.pdg);
+    analysisManager->FillNtupleDColumn(kHitNtuple, 5, hit.edep);
+    analysisManager->FillNtupleDColumn(kHitNtuple, 6, position.x());
+    analysisManager->FillNtupleDColumn(kHitNtuple, 7, position.y());
+    analysisManager->FillNtupleDColumn(kHitNtuple, 8, position.z());
+    analysisManager->FillNtupleDColumn(kHitNtuple, 9, hit.firstTime);
+    analysisManager->FillNtupleIColumn(kHitNtuple, 10, hit.nSteps);
+    analysisManager->FillNtupleDColumn(kHitNtuple, 11, hit.weightedEdep / hit.edep);
+    analysisManager->AddNtupleRow(kHitNtuple);
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
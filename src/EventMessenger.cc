@@ -0,0 +1,134 @@
+#include "EventMessenger.hh"
+#include "EventAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4SystemOfUnits.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventMessenger::EventMessenger(EventAction * eventAction)
+:fEventAction(eventAction)
+{ 
+  fRecordDir = new G4UIdirectory("/record/");
+  fRecordDir->SetGuidance("Choose what is written for the sensitive volumes.");
+
+  fModeCmd = new G4UIcmdWithAString("/record/mode",this);
+  fModeCmd->SetGuidance("step : one event-ntuple row per recorded step");
+  fModeCmd->SetGuidance("hit  : summed deposits per event and volume copy");
+  fModeCmd->SetGuidance("both : fill both ntuples");
+  fModeCmd->SetParameterName("mode",false);
+  fModeCmd->SetCandidates("step hit both");
+  fModeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fHitsPerTrackCmd = new G4UIcmdWithABool("/record/hitsPerTrack",this);
+  fHitsPerTrackCmd->SetGuidance("Keep one hit per track (true) or sum all");
+  fHitsPerTrackCmd->SetGuidance("tracks of an event in a volume copy (false).");
+  fHitsPerTrackCmd->SetParameterName("flag",true);
+  fHitsPerTrackCmd->SetDefaultValue(true);
+  fHitsPerTrackCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fTriggerDir = new G4UIdirectory("/record/trigger/");
+  fTriggerDir->SetGuidance("Xe - scintillator coincidence trigger.");
+
+  fTriggerCmd = new G4UIcmdWithABool("/record/trigger/enable",this);
+  fTriggerCmd->SetGuidance("Only write events passing the coincidence trigger.");
+  fTriggerCmd->SetGuidance("Not unbiased with /Runmodel/bias/ splitting or forced");
+  fTriggerCmd->SetGuidance("collisions: the thresholds are not linear in the weights.");
+  fTriggerCmd->SetParameterName("flag",true);
+  fTriggerCmd->SetDefaultValue(true);
+  fTriggerCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fXeThresholdCmd = new G4UIcmdWithADoubleAndUnit("/record/trigger/xeThreshold",this);
+  fXeThresholdCmd->SetGuidance("Minimum energy deposit in the Xe target.");
+  fXeThresholdCmd->SetParameterName("edep",false);
+  fXeThresholdCmd->SetRange("edep>=0.");
+  fXeThresholdCmd->SetUnitCategory("Energy");
+  fXeThresholdCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fScintorThresholdCmd = new G4UIcmdWithADoubleAndUnit("/record/trigger/scintThreshold",this);
+  fScintorThresholdCmd->SetGuidance("Minimum energy deposit in one scintillator copy.");
+  fScintorThresholdCmd->SetParameterName("edep",false);
+  fScintorThresholdCmd->SetRange("edep>=0.");
+  fScintorThresholdCmd->SetUnitCategory("Energy");
+  fScintorThresholdCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fWindowCmd = new G4UIcmdWithADoubleAndUnit("/record/trigger/window",this);
+  fWindowCmd->SetGuidance("Coincidence window after the first Xe deposit;");
+  fWindowCmd->SetGuidance("0 accepts any time difference.");
+  fWindowCmd->SetParameterName("window",false);
+  fWindowCmd->SetRange("window>=0.");
+  fWindowCmd->SetUnitCategory("Time");
+  fWindowCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fEarlyAbortCmd = new G4UIcmdWithAString("/record/trigger/earlyAbort",this);
+  fEarlyAbortCmd->SetGuidance("Drop the remaining tracks of events that cannot");
+  fEarlyAbortCmd->SetGuidance("pass the enabled trigger anymore:");
+  fEarlyAbortCmd->SetGuidance("never   : track every event to completion");
+  fEarlyAbortCmd->SetGuidance("energy  : when the energy left to deposit is below");
+  fEarlyAbortCmd->SetGuidance("          the Xe or scintillator threshold");
+  fEarlyAbortCmd->SetGuidance("primary : also when the primary did not interact");
+  fEarlyAbortCmd->SetGuidance("          in the Xe target");
+  fEarlyAbortCmd->SetParameterName("policy",false);
+  fEarlyAbortCmd->SetCandidates("never energy primary");
+  fEarlyAbortCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventMessenger::~EventMessenger()
+{
+  delete fModeCmd;
+  delete fHitsPerTrackCmd;
+  delete fTriggerCmd;
+  delete fXeThresholdCmd;
+  delete fScintorThresholdCmd;
+  delete fWindowCmd;
+  delete fEarlyAbortCmd;
+  delete fTriggerDir;
+  delete fRecordDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{ 
+  if( command == fModeCmd )
+  {
+    G4int mode = kRecordSteps;
+    if (newValue == "hit") mode = kRecordHits;
+    if (newValue == "both") mode = kRecordBoth;
+    fEventAction->SetRecordMode(mode);
+  }
+  if( command == fHitsPerTrackCmd )
+  {
+    fEventAction->SetHitsPerTrack(fHitsPerTrackCmd->GetNewBoolValue(newValue));
+  }
+  if( command == fTriggerCmd )
+  {
+    fEventAction->SetTrigger(fTriggerCmd->GetNewBoolValue(newValue));
+  }
+  // Hits store deposits in keV and times in ns
+  if( command == fXeThresholdCmd )
+  {
+    fEventAction->SetXeThreshold(fXeThresholdCmd->GetNewDoubleValue(newValue)/keV);
+  }
+  if( command == fScintorThresholdCmd )
+  {
+    fEventAction->SetScintorThreshold(
+      fScintorThresholdCmd->GetNewDoubleValue(newValue)/keV);
+  }
+  if( command == fWindowCmd )
+  {
+    fEventAction->SetCoincidenceWindow(fWindowCmd->GetNewDoubleValue(newValue)/ns);
+  }
+  if( command == fEarlyAbortCmd )
+  {
+    G4int policy = kAbortNever;
+    if (newValue == "energy") policy = kAbortEnergy;
+    if (newValue == "primary") policy = kAbortPrimary;
+    fEventAction->SetEarlyAbort(policy);
+  }
+}
@@ -0,0 +1,60 @@
+/// \file ImportanceBiasingOperator.cc
+/// \brief Implementation of the ImportanceBiasingOperator class
+
+#include "ImportanceBiasingOperator.hh"
+#include "SplitOrKillOperation.hh"
+
+#include "G4ParticleTable.hh"
+#include "G4Track.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImportanceBiasingOperator::ImportanceBiasingOperator(const G4String& particleName)
+: G4VBiasingOperator("ImportanceSplitting_" + particleName),
+  fParticle(0),
+  fSplitOrKill(0)
+{
+  fParticle = G4ParticleTable::GetParticleTable()->FindParticle(particleName);
+  if (!fParticle) {
+    G4ExceptionDescription description;
+    description << "Particle " << particleName
+                << " not found, no importance biasing";
+    G4Exception("ImportanceBiasingOperator::ImportanceBiasingOperator()",
+                "Bias001", JustWarning, description);
+  }
+  fSplitOrKill = new SplitOrKillOperation("SplitOrKill", this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ImportanceBiasingOperator::~ImportanceBiasingOperator()
+{
+  delete fSplitOrKill;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ImportanceBiasingOperator::SetImportance(const G4LogicalVolume* volume,
+                                              G4double importance)
+{
+  fImportances[volume] = importance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double ImportanceBiasingOperator::GetImportance(const G4LogicalVolume* volume) const
+{
+  auto it = fImportances.find(volume);
+  return (it == fImportances.end()) ? 1. : it->second;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VBiasingOperation* ImportanceBiasingOperator::ProposeNonPhysicsBiasingOperation(
+  const G4Track* track, const G4BiasingProcessInterface*)
+{
+  if (track->GetDefinition() != fParticle) return 0;
+  return fSplitOrKill;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
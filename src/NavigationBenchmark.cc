@@ -0,0 +1,90 @@
+/// \file NavigationBenchmark.cc
+/// \brief Implementation of the NavigationBenchmark class
+
+#include "NavigationBenchmark.hh"
+
+#include "G4Navigator.hh"
+#include "G4GeometryManager.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4Timer.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+#include "CLHEP/Random/MixMaxRng.h"
+
+#include <cmath>
+
+namespace {
+  // A ray stuck on a surface must not hang the benchmark
+  const G4int kMaxStepsPerRay = 100000;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NavigationBenchmark::NavigationBenchmark(G4VPhysicalVolume* world, G4long seed)
+: fWorld(world),
+  fSeed(seed)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NavigationBenchmark::~NavigationBenchmark()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NavigationBenchmark::Run(G4int nRays, const G4ThreeVector& centre,
+                              const G4ThreeVector& halfSize)
+{
+  // Voxels are built when the geometry is closed; the run manager closes
+  // it at the first BeamOn
+  G4GeometryManager* geometryManager = G4GeometryManager::GetInstance();
+  if (!geometryManager->IsGeometryClosed()) geometryManager->CloseGeometry(true);
+
+  // Own engine: the rays do not depend on, nor change, the event seeds
+  CLHEP::MixMaxRng engine(fSeed);
+  G4Navigator navigator;
+  navigator.SetWorldVolume(fWorld);
+
+  G4long nSteps = 0;
+  G4int nStuck = 0;
+  G4Timer timer;
+  timer.Start();
+  for (G4int ray = 0; ray < nRays; ++ray) {
+    G4ThreeVector position(
+      centre.x() + halfSize.x()*(2*CLHEP::RandFlat::shoot(&engine) - 1),
+      centre.y() + halfSize.y()*(2*CLHEP::RandFlat::shoot(&engine) - 1),
+      centre.z() + halfSize.z()*(2*CLHEP::RandFlat::shoot(&engine) - 1));
+    G4double cosTheta = 2*CLHEP::RandFlat::shoot(&engine) - 1;
+    G4double sinTheta = std::sqrt(1. - cosTheta*cosTheta);
+    G4double phi = twopi*CLHEP::RandFlat::shoot(&engine);
+    G4ThreeVector direction(sinTheta*std::cos(phi), sinTheta*std::sin(phi),
+                            cosTheta);
+
+    G4VPhysicalVolume* volume =
+      navigator.LocateGlobalPointAndSetup(position, &direction, false, false);
+    G4int steps = 0;
+    while (volume && steps < kMaxStepsPerRay) {
+      G4double safety = 0.;
+      G4double step = navigator.ComputeStep(position, direction, kInfinity, safety);
+      if (step == kInfinity) break;
+      position += step*direction;
+      navigator.SetGeometricallyLimitedStep();
+      volume = navigator.LocateGlobalPointAndSetup(position, &direction, true);
+      ++steps;
+    }
+    if (steps == kMaxStepsPerRay) ++nStuck;
+    nSteps += steps;
+  }
+  timer.Stop();
+
+  G4double seconds = timer.GetRealElapsed();
+  G4cout << "Navigation benchmark: " << nRays << " rays, " << nSteps
+         << " steps in " << seconds << " s (" << nRays/seconds << " rays/s, "
+         << nSteps/seconds << " steps/s, "
+         << (nRays > 0 ? G4double(nSteps)/nRays : 0.) << " steps/ray)";
+  if (nStuck) G4cout << ", " << nStuck << " rays stopped after "
+                     << kMaxStepsPerRay << " steps";
+  G4cout << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
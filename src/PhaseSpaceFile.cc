@@ -0,0 +1,130 @@
+/// \file PhaseSpaceFile.cc
+/// \brief Implementation of the PhaseSpaceFile class
+
+#include "PhaseSpaceFile.hh"
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+  // Records read at once while indexing
+  const std::size_t kIndexBlock = 65536;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const PhaseSpaceFile* PhaseSpaceFile::Get(const G4String& fileName)
+{
+  static std::mutex mutex;
+  static std::map<G4String, std::unique_ptr<PhaseSpaceFile>> files;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto found = files.find(fileName);
+  if (found != files.end()) return found->second.get();
+
+  std::unique_ptr<PhaseSpaceFile> file(new PhaseSpaceFile(fileName));
+  G4ExceptionDescription description;
+  if (!file->Index(description)) {
+    G4Exception("PhaseSpaceFile::Get()", "Source002", JustWarning, description);
+    return 0;
+  }
+  // Replayed results are normalised per simulated source event
+  G4cout << "Phase space " << fileName << ": " << file->GetNumberOfRecords()
+         << " particles from " << file->GetNumberOfEvents() << " of "
+         << file->GetNumberOfSourceEvents() << " source events" << G4endl;
+  if (file->GetNumberOfSourceEvents() == 0) {
+    G4cout << "  the recording run did not finish, the number of source"
+           << " events is unknown" << G4endl;
+  }
+  const PhaseSpaceFile* result = file.get();
+  files[fileName] = std::move(file);
+  return result;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceFile::PhaseSpaceFile(const G4String& fileName)
+ : fFileName(fileName),
+   fDescriptor(-1),
+   fNSourceEvents(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceFile::~PhaseSpaceFile()
+{
+  if (fDescriptor >= 0) close(fDescriptor);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceFile::Index(G4ExceptionDescription& description)
+{
+  fDescriptor = open(fFileName.c_str(), O_RDONLY);
+  if (fDescriptor < 0) {
+    description << "Cannot open " << fFileName;
+    return false;
+  }
+
+  PhaseSpaceFileHeader header;
+  if (pread(fDescriptor, &header, sizeof(header), 0) != sizeof(header) ||
+      std::memcmp(header.magic, kPhaseSpaceFileMagic, sizeof(header.magic)) ||
+      header.version != kPhaseSpaceFileVersion ||
+      header.recordSize != sizeof(PhaseSpaceRecord)) {
+    description << fFileName << " is not a phase-space file of version "
+                << kPhaseSpaceFileVersion;
+    return false;
+  }
+  fNSourceEvents = header.nSourceEvents;
+
+  // A new event starts wherever the event ID changes
+  std::vector<PhaseSpaceRecord> block(kIndexBlock);
+  G4long nRecords = 0;
+  G4int previousID = 0;
+  off_t offset = sizeof(header);
+  for (;;) {
+    ssize_t nBytes = pread(fDescriptor, block.data(),
+                           block.size() * sizeof(PhaseSpaceRecord), offset);
+    if (nBytes <= 0) break;
+    std::size_t nRead = nBytes / sizeof(PhaseSpaceRecord);
+    for (std::size_t i = 0; i < nRead; ++i) {
+      if (nRecords == 0 || block[i].eventID != previousID) {
+        fFirst.push_back(nRecords);
+      }
+      previousID = block[i].eventID;
+      ++nRecords;
+    }
+    if (nRead < block.size()) break;
+    offset += nBytes;
+  }
+  fFirst.push_back(nRecords);
+
+  if (nRecords == 0) {
+    description << fFileName << " holds no particles";
+    return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceFile::ReadEvent(G4int index,
+                               std::vector<PhaseSpaceRecord>& records) const
+{
+  G4long first = fFirst[index];
+  records.resize(fFirst[index + 1] - first);
+  off_t offset = sizeof(PhaseSpaceFileHeader) + first * sizeof(PhaseSpaceRecord);
+  std::size_t nBytes = records.size() * sizeof(PhaseSpaceRecord);
+  if (pread(fDescriptor, records.data(), nBytes, offset) != ssize_t(nBytes)) {
+    G4ExceptionDescription description;
+    description << "Cannot read event " << index << " of " << fFileName;
+    G4Exception("PhaseSpaceFile::ReadEvent()", "Source003",
+                FatalException, description);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,245 @@
+/// \file PhaseSpaceRecorder.cc
+/// \brief Implementation of the PhaseSpaceRecorder class
+
+#include "PhaseSpaceRecorder.hh"
+#include "PhaseSpaceRecord.hh"
+#include "SeedManager.hh"
+#include "RunAction.hh"
+
+#include "G4Step.hh"
+#include "G4StepPoint.hh"
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+G4ThreadLocal std::vector<PhaseSpaceRecord>* PhaseSpaceRecorder::fChunk = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceRecorder* PhaseSpaceRecorder::Instance()
+{
+  static PhaseSpaceRecorder instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// The default surface is a few mm off the SS container wall and end caps
+// and stays inside the default scintillator array (14.96 cm at the cube
+// corners); the flanges (15.2 cm) reach through it, which is harmless as
+// long as they do not change between recording and replay
+PhaseSpaceRecorder::PhaseSpaceRecorder()
+ : fFileName("none"),
+   fRadius(13.*cm),
+   fHalfLength(26.*cm),
+   fZCentre(9.02*cm),
+   fFile(0),
+   fNRecords(0),
+   fFailed(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceRecorder::~PhaseSpaceRecorder()
+{
+  Close(0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceRecorder::SetSurface(G4double radius, G4double halfLength,
+                                    G4double zCentre)
+{
+  fRadius = radius;
+  fHalfLength = halfLength;
+  fZCentre = zCentre;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceRecorder::IsInside(const G4ThreeVector& position) const
+{
+  return position.perp2() < fRadius * fRadius &&
+         std::abs(position.z() - fZCentre) < fHalfLength;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceRecorder::Open(const G4String& outputFile)
+{
+  if (fFile) Close(0);
+  if (fFileName == "none" || fFileName.empty()) return;
+
+  fOpenFile = fFileName;
+  if (fFileName == "auto") {
+    fOpenFile = RunAction::SideFileName(outputFile, ".phsp");
+  }
+  if (!fWrittenFiles.insert(fOpenFile).second) {
+    G4ExceptionDescription description;
+    description << fOpenFile << " already holds an earlier run of this job and"
+                << " is overwritten; /output/phaseSpace auto writes one file"
+                << " per output file";
+    G4Exception("PhaseSpaceRecorder::Open()", "PhaseSpace002",
+                JustWarning, description);
+  }
+
+  fFile = std::fopen(fOpenFile.c_str(), "wb");
+  if (!fFile) {
+    G4ExceptionDescription description;
+    description << "Cannot open " << fOpenFile << " for writing";
+    G4Exception("PhaseSpaceRecorder::Open()", "PhaseSpace001",
+                FatalException, description);
+    return;
+  }
+
+  PhaseSpaceFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kPhaseSpaceFileMagic, sizeof(header.magic));
+  header.version = kPhaseSpaceFileVersion;
+  header.recordSize = sizeof(PhaseSpaceRecord);
+  header.radius = fRadius / mm;
+  header.halfLength = fHalfLength / mm;
+  header.zCentre = fZCentre / mm;
+  header.seed = SeedManager::GetBaseSeed();
+  header.jobIndex = SeedManager::GetJobIndex();
+  header.numJobs = SeedManager::GetNumJobs();
+  fNRecords = 0;
+  fFailed = false;
+  if (std::fwrite(&header, sizeof(header), 1, fFile) != 1) Fail("write");
+
+  G4cout << "Recording the particles leaving r < " << G4BestUnit(fRadius, "Length")
+         << ", |z - " << G4BestUnit(fZCentre, "Length") << "| < "
+         << G4BestUnit(fHalfLength, "Length") << " to " << fOpenFile << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceRecorder::Close(G4int nSourceEvents)
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  if (!fFile) return;
+  std::uint32_t nEvents = nSourceEvents;
+  if (!fFailed) {
+    if (std::fseek(fFile, offsetof(PhaseSpaceFileHeader, nSourceEvents),
+                   SEEK_SET) != 0) Fail("seek in");
+    else if (std::fwrite(&nEvents, sizeof(nEvents), 1, fFile) != 1) {
+      Fail("write");
+    }
+  }
+  if (std::fclose(fFile) != 0) Fail("close");
+  fFile = 0;
+  G4cout << " Phase space: " << fNRecords << " particles of " << nSourceEvents
+         << " events written to " << fOpenFile
+         << (fFailed ? ", INCOMPLETE" : "") << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceRecorder::RecordStep(const G4Step* step, G4int eventID)
+{
+  const G4StepPoint* pre = step->GetPreStepPoint();
+  const G4StepPoint* post = step->GetPostStepPoint();
+  const G4ThreeVector& start = pre->GetPosition();
+  if (!IsInside(start) || IsInside(post->GetPosition())) return false;
+
+  // Fraction of the chord where it leaves the cylinder: through the side,
+  // a t^2 + 2 b t + c = 0 with c < 0 inside, or through an end cap
+  G4ThreeVector delta = post->GetPosition() - start;
+  G4double fraction = 1.;
+  G4double a = delta.perp2();
+  if (a > 0.) {
+    G4double b = start.x() * delta.x() + start.y() * delta.y();
+    G4double c = start.perp2() - fRadius * fRadius;
+    fraction = std::min(fraction, (-b + std::sqrt(b * b - a * c)) / a);
+  }
+  if (delta.z() > 0.) {
+    fraction = std::min(fraction,
+                        (fZCentre + fHalfLength - start.z()) / delta.z());
+  }
+  else if (delta.z() < 0.) {
+    fraction = std::min(fraction,
+                        (fZCentre - fHalfLength - start.z()) / delta.z());
+  }
+  fraction = std::max(fraction, 0.);
+
+  // An interaction ends the step beyond the surface, so the state on it
+  // is the one at the start of the step. Exact for neutral particles;
+  // charged ones lose the continuous loss of this one step.
+  G4ThreeVector position = start + fraction * delta;
+  G4ThreeVector direction = delta.unit();
+  PhaseSpaceRecord record;
+  record.eventID = eventID;
+  record.pdg = step->GetTrack()->GetDefinition()->GetPDGEncoding();
+  record.position[0] = position.x() / mm;
+  record.position[1] = position.y() / mm;
+  record.position[2] = position.z() / mm;
+  record.direction[0] = direction.x();
+  record.direction[1] = direction.y();
+  record.direction[2] = direction.z();
+  record.energy = pre->GetKineticEnergy() / MeV;
+  record.time = (pre->GetGlobalTime() +
+                 fraction * (post->GetGlobalTime() - pre->GetGlobalTime())) / ns;
+  record.weight = pre->GetWeight();
+
+  if (!fChunk) {
+    fChunk = new std::vector<PhaseSpaceRecord>;
+    fChunk->reserve(kChunkRecords);
+  }
+  fChunk->push_back(record);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceRecorder::EndEvent()
+{
+  if (fChunk && fChunk->size() >= kChunkRecords) Write(fChunk);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceRecorder::Flush()
+{
+  if (fChunk && !fChunk->empty()) Write(fChunk);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceRecorder::Write(std::vector<PhaseSpaceRecord>* chunk)
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (fFile && !fFailed) {
+      if (std::fwrite(chunk->data(), sizeof(PhaseSpaceRecord), chunk->size(),
+                      fFile) != chunk->size()) Fail("write");
+      else fNRecords += chunk->size();
+    }
+  }
+  chunk->clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceRecorder::Fail(const char* what)
+{
+  // Called under the lock, or by the master alone; reported once
+  G4int error = errno;
+  if (fFailed) return;
+  fFailed = true;
+  G4ExceptionDescription description;
+  description << "Cannot " << what << " " << fOpenFile << " ("
+              << std::strerror(error) << "), it is incomplete after "
+              << fNRecords << " particles";
+  G4Exception("PhaseSpaceRecorder::Write()", "PhaseSpace003",
+              JustWarning, description);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
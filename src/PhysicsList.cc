@@ -1,40 +1,98 @@
 #include "PhysicsList.hh"
+#include "PhysicsListMessenger.hh"
 #include "G4DecayPhysics.hh"
 #include "G4RadioactiveDecayPhysics.hh"
 #include "G4EmStandardPhysics.hh"
+#include "G4EmStandardPhysics_option1.hh"
 #include "G4HadronElasticPhysicsHP.hh"
 #include "G4HadronPhysicsQGSP_BIC_HP.hh"
 #include "G4IonPhysics.hh"
 #include "G4StoppingPhysics.hh"
 #include "G4NeutronTrackingCut.hh"
+#include "G4GenericBiasingPhysics.hh"
+#include "G4StepLimiterPhysics.hh"
 #include "G4LossTableManager.hh"
 #include "G4GenericIon.hh"
-#include "G4UserLimits.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4Neutron.hh"
+#include "G4ProcessManager.hh"
+#include "G4HadronicProcess.hh"
+#include "G4HadronicInteraction.hh"
+#include "G4BiasingProcessInterface.hh"
+
+#include <algorithm>
 using namespace CLHEP;
 
-PhysicsList::PhysicsList() : G4VModularPhysicsList() {
+namespace {
+    // 标准 HP 模型的适用上限
+    const G4double kHPLimit = 20 * MeV;
+}
+
+PhysicsList::PhysicsList()
+: G4VModularPhysicsList(), fMessenger(0), fConfiguration("precision"),
+  fRadioactiveDecay(0), fHPMaxEnergy(kHPLimit), fBiasingPhysics(0) {
     SetVerboseLevel(1);
+    fMessenger = new PhysicsListMessenger(this);
 
-    // 添加标准物理过程
+    // 添加标准物理过程 ("precision" 配置)
     RegisterPhysics(new G4DecayPhysics());
-    RegisterPhysics(new G4RadioactiveDecayPhysics());
+    fRadioactiveDecay = new G4RadioactiveDecayPhysics();
+    RegisterPhysics(fRadioactiveDecay);
     RegisterPhysics(new G4EmStandardPhysics());
     RegisterPhysics(new G4HadronElasticPhysicsHP());
     RegisterPhysics(new G4HadronPhysicsQGSP_BIC_HP()); // 处理中子非弹性散射
     RegisterPhysics(new G4IonPhysics()); // 确保离子（包括 Xe）可以正确追踪
     RegisterPhysics(new G4StoppingPhysics()); // 处理高能粒子停止
     RegisterPhysics(new G4NeutronTrackingCut()); // 允许跟踪低能中子
+    RegisterPhysics(new G4StepLimiterPhysics()); // 区域 G4UserLimits (/Runmodel/region/setLimit)
 }
 
-PhysicsList::~PhysicsList() {}
+PhysicsList::~PhysicsList() {
+    delete fMessenger;
+}
+
+void PhysicsList::EnableBiasing(const G4String& particleName) {
+    if (std::find(fBiasedParticles.begin(), fBiasedParticles.end(),
+                  particleName) != fBiasedParticles.end()) return;
+    fBiasedParticles.push_back(particleName);
+
+    // 包装该粒子的物理过程，并加上非物理 (几何) 偏倚过程；
+    // 偏倚算子在 DetectorConstruction::ConstructSDandField 中挂到体积上
+    if (!fBiasingPhysics) {
+        fBiasingPhysics = new G4GenericBiasingPhysics();
+        RegisterPhysics(fBiasingPhysics);
+    }
+    fBiasingPhysics->Bias(particleName);
+}
+
+void PhysicsList::SetConfiguration(const G4String& name) {
+    if (name == fConfiguration) return;
+    fConfiguration = name;
+
+    // ReplacePhysics 替换同类型 (电磁) 的构造器
+    if (name == "fast") {
+        ReplacePhysics(new G4EmStandardPhysics_option1());
+        if (fRadioactiveDecay) {
+            RemovePhysics(fRadioactiveDecay);
+            delete fRadioactiveDecay;
+            fRadioactiveDecay = 0;
+        }
+    } else {
+        ReplacePhysics(new G4EmStandardPhysics());
+        if (!fRadioactiveDecay) {
+            fRadioactiveDecay = new G4RadioactiveDecayPhysics();
+            RegisterPhysics(fRadioactiveDecay);
+        }
+    }
+}
 
 void PhysicsList::SetCuts() {
-    // 调整默认的粒子跟踪切割能量，以确保 Xe 运动被记录
-    SetCutValue(1 * mm, "gamma");
-    SetCutValue(1 * mm, "e-");
-    SetCutValue(1 * mm, "e+");
-    SetCutValue(0.1 * mm, "proton"); // 让低能质子更容易被追踪
+    // 世界 (被动材料) 的默认切割取粗值；LXe 靶和闪烁体区域保留细切割，
+    // 见 DetectorConstruction::DefineRegions 与 /Runmodel/region/setCut
+    SetCutValue(1 * cm, "gamma");
+    SetCutValue(1 * cm, "e-");
+    SetCutValue(1 * cm, "e+");
+    SetCutValue(1 * mm, "proton");
     SetCutValue(0.1 * mm, "neutron");
     SetCutValue(0.01 * mm, "ion"); // 关键！降低 Xe 的切割值
 
@@ -43,9 +101,31 @@ void PhysicsList::SetCuts() {
 }
 
 void PhysicsList::ConstructProcess() {
+    // G4IonPhysics 已注册，不再另外构建一次
     G4VModularPhysicsList::ConstructProcess();
+    if (fHPMaxEnergy < kHPLimit) LimitNeutronHP();
+}
 
-    // 确保 ion 过程不会被忽略
-    G4IonPhysics* ionPhysics = new G4IonPhysics();
-    ionPhysics->ConstructProcess();
+void PhysicsList::LimitNeutronHP() {
+    // 每个线程各自的过程与模型：HP 模型截到 fHPMaxEnergy，
+    // 原来从 ~20 MeV 开始的模型 (BIC, CHIPS, nRadCapture...) 下延到该能量
+    G4ProcessVector* processes = G4Neutron::Definition()->GetProcessManager()->GetProcessList();
+    for (G4int i = 0; i < G4int(processes->size()); ++i) {
+        G4VProcess* process = (*processes)[i];
+        G4BiasingProcessInterface* wrapper = dynamic_cast<G4BiasingProcessInterface*>(process);
+        if (wrapper) process = wrapper->GetWrappedProcess();
+        G4HadronicProcess* hadronic = dynamic_cast<G4HadronicProcess*>(process);
+        if (!hadronic) continue;
+        for (G4HadronicInteraction* model : hadronic->GetHadronicInteractionList()) {
+            if (model->GetModelName().find("NeutronHP") != std::string::npos) {
+                if (model->GetMaxEnergy() > fHPMaxEnergy) model->SetMaxEnergy(fHPMaxEnergy);
+            } else if (model->GetMinEnergy() > fHPMaxEnergy &&
+                       model->GetMinEnergy() <= kHPLimit) {
+                model->SetMinEnergy(fHPMaxEnergy);
+            }
+        }
+    }
+    if (verboseLevel > 0) {
+        G4cout << "Neutron HP models limited to " << fHPMaxEnergy / MeV << " MeV" << G4endl;
+    }
 }
@@ -0,0 +1,70 @@
+#include "PhysicsListMessenger.hh"
+#include "PhysicsList.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsListMessenger::PhysicsListMessenger(PhysicsList * physicsList)
+:fPhysicsList(physicsList)
+{ 
+  fPhysicsDir = new G4UIdirectory("/physics/");
+  fPhysicsDir->SetGuidance("Physics list options.");
+
+  fBiasingCmd = new G4UIcmdWithAString("/physics/biasing",this);
+  fBiasingCmd->SetGuidance("Add generic biasing processes for a particle,");
+  fBiasingCmd->SetGuidance("needed by the /Runmodel/bias/ commands.");
+  fBiasingCmd->SetParameterName("particle",true);
+  fBiasingCmd->SetDefaultValue("neutron");
+  fBiasingCmd->AvailableForStates(G4State_PreInit);
+  // The physics list is shared with the worker threads
+  fBiasingCmd->SetToBeBroadcasted(false);
+
+  fConfigurationCmd = new G4UIcmdWithAString("/physics/configuration",this);
+  fConfigurationCmd->SetGuidance("precision : full physics, for production");
+  fConfigurationCmd->SetGuidance("fast      : EM option1, no radioactive decay,");
+  fConfigurationCmd->SetGuidance("            for geometry scans");
+  fConfigurationCmd->SetParameterName("name",false);
+  fConfigurationCmd->SetCandidates("precision fast");
+  fConfigurationCmd->AvailableForStates(G4State_PreInit);
+  fConfigurationCmd->SetToBeBroadcasted(false);
+
+  fHPMaxEnergyCmd = new G4UIcmdWithADoubleAndUnit("/physics/hpMaxEnergy",this);
+  fHPMaxEnergyCmd->SetGuidance("Use the neutron HP models only below this energy,");
+  fHPMaxEnergyCmd->SetGuidance("the cascade and CHIPS models above (default 20 MeV).");
+  fHPMaxEnergyCmd->SetParameterName("energy",false);
+  fHPMaxEnergyCmd->SetRange("energy>0.");
+  fHPMaxEnergyCmd->SetUnitCategory("Energy");
+  fHPMaxEnergyCmd->AvailableForStates(G4State_PreInit);
+  fHPMaxEnergyCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsListMessenger::~PhysicsListMessenger()
+{
+  delete fBiasingCmd;
+  delete fConfigurationCmd;
+  delete fHPMaxEnergyCmd;
+  delete fPhysicsDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsListMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{ 
+  if( command == fBiasingCmd )
+  {
+    fPhysicsList->EnableBiasing(newValue);
+  }
+  if( command == fConfigurationCmd )
+  {
+    fPhysicsList->SetConfiguration(newValue);
+  }
+  if( command == fHPMaxEnergyCmd )
+  {
+    fPhysicsList->SetHPMaxEnergy(fHPMaxEnergyCmd->GetNewDoubleValue(newValue));
+  }
+}
@@ -1,20 +1,41 @@
 #include "PrimaryGeneratorAction.hh"
+#include "PrimaryGeneratorMessenger.hh"
+#include "SeedManager.hh"
+#include "PhaseSpaceFile.hh"
 
 #include "G4LogicalVolumeStore.hh"
 #include "G4LogicalVolume.hh"
 #include "G4Box.hh"
 #include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4Event.hh"
 #include "G4ParticleGun.hh"
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
+#include "G4IonTable.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
 #include "G4GeneralParticleSource.hh"
+#include "G4Threading.hh"
 #include "Randomize.hh"
 
+#include <cmath>
+#include <sstream>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 PrimaryGeneratorAction::PrimaryGeneratorAction()
-: G4VUserPrimaryGeneratorAction()
+: G4VUserPrimaryGeneratorAction(),
+  fMode(kSourceGPS),
+  fPosition(0., 0., 9.02*cm),
+  fDirection(),
+  fEnergy(2.45*MeV),
+  fNPhaseSpaceEvents(0),
+  fRecycle(1),
+  fRotate(false),
+  fWrapped(false)
 {
   /*
   G4int n_particle = 1;
@@ -29,18 +50,169 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
   fParticleGun->SetParticleMomentumDirection(G4ThreeVector(0.,1.,0.));
   fParticleGun->SetParticleEnergy(2.45*MeV);*/
   fParticleGun  = new G4GeneralParticleSource();
+
+  // Native source: by default the point of pos.mac
+  fGun = new G4ParticleGun(1);
+  fGun->SetParticleDefinition(
+    G4ParticleTable::GetParticleTable()->FindParticle("neutron"));
+  fMessenger = new PrimaryGeneratorMessenger(this);
 }
 PrimaryGeneratorAction::~PrimaryGeneratorAction()
 {
+  delete fMessenger;
+  delete fGun;
   delete fParticleGun;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void PrimaryGeneratorAction::SetParticle(const G4String& particleName)
+{
+  G4ParticleDefinition* particle =
+    G4ParticleTable::GetParticleTable()->FindParticle(particleName);
+  if (!particle) {
+    G4cout << "Unknown particle " << particleName << ", ignored" << G4endl;
+    return;
+  }
+  fGun->SetParticleDefinition(particle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetDirection(const G4ThreeVector& direction)
+{
+  fDirection = (direction.mag2() > 0.) ? direction.unit() : G4ThreeVector();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetEnergy(G4double energy)
+{
+  fEnergy = energy;
+  fSpectrum.Clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::LoadSpectrum(const G4String& fileName,
+                                          G4bool histogram)
+{
+  fSpectrum.Load(fileName, histogram);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorAction::SetPhaseSpaceFiles(const G4String& fileNames)
+{
+  // Indexed once, shared with the other threads. Several files (the parts
+  // of a checkpointed recording) are replayed one after the other.
+  std::vector<const PhaseSpaceFile*> files;
+  G4int nEvents = 0;
+  G4long nSourceEvents = 0;
+  std::istringstream is(fileNames);
+  G4String fileName;
+  while (is >> fileName) {
+    const PhaseSpaceFile* file = PhaseSpaceFile::Get(fileName);
+    if (!file) return;
+    files.push_back(file);
+    nEvents += file->GetNumberOfEvents();
+    nSourceEvents += file->GetNumberOfSourceEvents();
+  }
+  if (files.empty()) return;
+  fPhaseSpaces.swap(files);
+  fNPhaseSpaceEvents = nEvents;
+  fWrapped = false;
+  if (fPhaseSpaces.size() > 1 && G4Threading::G4GetThreadId() <= 0) {
+    G4cout << "Phase space: " << fNPhaseSpaceEvents << " events of "
+           << nSourceEvents << " source events in " << fPhaseSpaces.size()
+           << " files" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
-  fParticleGun->GeneratePrimaryVertex(anEvent);
+  // Every event starts its own stream, before anything is sampled
+  G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+  SeedManager::SeedEvent(runID, anEvent->GetEventID());
+  if (fMode == kSourceGPS) {
+    fParticleGun->GeneratePrimaryVertex(anEvent);
+    return;
+  }
+  if (fMode == kSourcePhaseSpace) {
+    GeneratePhaseSpace(anEvent);
+    return;
+  }
+
+  G4ThreeVector direction = fDirection;
+  if (direction.mag2() == 0.) {
+    G4double cosTheta = 2.*G4UniformRand() - 1.;
+    G4double sinTheta = std::sqrt(1. - cosTheta*cosTheta);
+    G4double phi = twopi*G4UniformRand();
+    direction.set(sinTheta*std::cos(phi), sinTheta*std::sin(phi), cosTheta);
+  }
+  fGun->SetParticlePosition(fPosition);
+  fGun->SetParticleMomentumDirection(direction);
+  fGun->SetParticleEnergy(fSpectrum.IsEmpty() ? fEnergy : fSpectrum.Sample());
+  fGun->GeneratePrimaryVertex(anEvent);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void PrimaryGeneratorAction::GeneratePhaseSpace(G4Event* anEvent)
+{
+  if (fPhaseSpaces.empty()) {
+    G4Exception("PrimaryGeneratorAction::GeneratePrimaries()", "Source004",
+                FatalException, "No phase-space file, see /source/phaseSpace");
+    return;
+  }
+
+  // By event number rather than in order of reading, so that a replay
+  // does not depend on the number of threads
+  G4long use = SeedManager::GetEventID(anEvent->GetEventID()) / fRecycle;
+  if (use >= fNPhaseSpaceEvents && !fWrapped) {
+    G4ExceptionDescription description;
+    description << "All " << fNPhaseSpaceEvents << " events of "
+                << fPhaseSpaces.front()->GetFileName()
+                << (fPhaseSpaces.size() > 1 ? " and the following files" : "")
+                << " used " << fRecycle << " time(s), starting over";
+    G4Exception("PrimaryGeneratorAction::GeneratePrimaries()", "Source005",
+                JustWarning, description);
+    fWrapped = true;
+  }
+  G4int index = G4int(use % fNPhaseSpaceEvents);
+  for (const PhaseSpaceFile* file : fPhaseSpaces) {
+    if (index < file->GetNumberOfEvents()) {
+      file->ReadEvent(index, fRecords);
+      break;
+    }
+    index -= file->GetNumberOfEvents();
+  }
+
+  // The geometry inside the recording surface is symmetric about the TPC
+  // axis, so the whole source event may be turned about it
+  G4double phi = fRotate ? twopi*G4UniformRand() : 0.;
+  G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
+  for (const auto& record : fRecords) {
+    G4ParticleDefinition* particle = particleTable->FindParticle(record.pdg);
+    if (!particle) particle = G4IonTable::GetIonTable()->GetIon(record.pdg);
+    if (!particle) continue;
+    G4ThreeVector position(record.position[0]*mm, record.position[1]*mm,
+                           record.position[2]*mm);
+    G4ThreeVector direction(record.direction[0], record.direction[1],
+                            record.direction[2]);
+    position.rotateZ(phi);
+    direction.rotateZ(phi);
+
+    G4PrimaryParticle* primary = new G4PrimaryParticle(particle);
+    primary->SetKineticEnergy(record.energy*MeV);
+    primary->SetMomentumDirection(direction.unit());
+    primary->SetWeight(record.weight);
+    G4PrimaryVertex* vertex = new G4PrimaryVertex(position, record.time*ns);
+    vertex->SetPrimary(primary);
+    anEvent->AddPrimaryVertex(vertex);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
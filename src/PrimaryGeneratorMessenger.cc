@@ -0,0 +1,156 @@
+#include "PrimaryGeneratorMessenger.hh"
+#include "PrimaryGeneratorAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWith3Vector.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction * primary)
+:fPrimary(primary)
+{ 
+  fSourceDir = new G4UIdirectory("/source/");
+  fSourceDir->SetGuidance("Native point source, used instead of the GPS with");
+  fSourceDir->SetGuidance("/source/mode native, and replay of a phase-space file");
+  fSourceDir->SetGuidance("with /source/mode phasespace.");
+
+  fModeCmd = new G4UIcmdWithAString("/source/mode",this);
+  fModeCmd->SetGuidance("gps    : G4GeneralParticleSource, set with /gps/");
+  fModeCmd->SetGuidance("native : the point source of /source/");
+  fModeCmd->SetGuidance("phasespace : the particles of /source/phaseSpace");
+  fModeCmd->SetParameterName("mode",false);
+  fModeCmd->SetCandidates("gps native phasespace");
+  fModeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fParticleCmd = new G4UIcmdWithAString("/source/particle",this);
+  fParticleCmd->SetGuidance("Primary particle (default neutron).");
+  fParticleCmd->SetParameterName("particle",false);
+  fParticleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPositionCmd = new G4UIcmdWith3VectorAndUnit("/source/position",this);
+  fPositionCmd->SetGuidance("Source point (default 0 0 9.02 cm).");
+  fPositionCmd->SetParameterName("x","y","z",false);
+  fPositionCmd->SetUnitCategory("Length");
+  fPositionCmd->SetDefaultUnit("cm");
+  fPositionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fDirectionCmd = new G4UIcmdWith3Vector("/source/direction",this);
+  fDirectionCmd->SetGuidance("Fixed direction of the primaries; 0 0 0 (the");
+  fDirectionCmd->SetGuidance("default) emits isotropically.");
+  fDirectionCmd->SetParameterName("dx","dy","dz",false);
+  fDirectionCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fEnergyCmd = new G4UIcmdWithADoubleAndUnit("/source/energy",this);
+  fEnergyCmd->SetGuidance("Mono energy (default 2.45 MeV), replaces a spectrum.");
+  fEnergyCmd->SetParameterName("energy",false);
+  fEnergyCmd->SetRange("energy>0.");
+  fEnergyCmd->SetUnitCategory("Energy");
+  fEnergyCmd->SetDefaultUnit("MeV");
+  fEnergyCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fSpectrumCmd = new G4UIcommand("/source/spectrum",this);
+  fSpectrumCmd->SetGuidance("Energy spectrum from a file of \"E(MeV) yield\" lines.");
+  fSpectrumCmd->SetGuidance("lin  : yields are densities, linear in between");
+  fSpectrumCmd->SetGuidance("hist : yield of a point = content of the bin up to");
+  fSpectrumCmd->SetGuidance("       the next point");
+  G4UIparameter* fileParam = new G4UIparameter("fileName",'s',false);
+  fSpectrumCmd->SetParameter(fileParam);
+  G4UIparameter* shapeParam = new G4UIparameter("shape",'s',true);
+  shapeParam->SetParameterCandidates("lin hist");
+  shapeParam->SetDefaultValue("lin");
+  fSpectrumCmd->SetParameter(shapeParam);
+  fSpectrumCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fPhaseSpaceCmd = new G4UIcmdWithAString("/source/phaseSpace",this);
+  fPhaseSpaceCmd->SetGuidance("Phase-space file(s) to replay, recorded with");
+  fPhaseSpaceCmd->SetGuidance("/output/phaseSpace; the particles of one source event");
+  fPhaseSpaceCmd->SetGuidance("make one event. Several files (e.g. the parts of a");
+  fPhaseSpaceCmd->SetGuidance("checkpointed recording) are used one after the other.");
+  fPhaseSpaceCmd->SetParameterName("fileNames",false);
+  fPhaseSpaceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRecycleCmd = new G4UIcmdWithAnInteger("/source/recycle",this);
+  fRecycleCmd->SetGuidance("Uses of every source event of the phase space in a row");
+  fRecycleCmd->SetGuidance("(default 1); best with /source/rotate.");
+  fRecycleCmd->SetParameterName("nUses",false);
+  fRecycleCmd->SetRange("nUses>=1");
+  fRecycleCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fRotateCmd = new G4UIcmdWithABool("/source/rotate",this);
+  fRotateCmd->SetGuidance("Turn every replayed source event by a random angle");
+  fRotateCmd->SetGuidance("about the TPC axis (default false).");
+  fRotateCmd->SetParameterName("rotate",false);
+  fRotateCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
+{
+  delete fModeCmd;
+  delete fParticleCmd;
+  delete fPositionCmd;
+  delete fDirectionCmd;
+  delete fEnergyCmd;
+  delete fSpectrumCmd;
+  delete fPhaseSpaceCmd;
+  delete fRecycleCmd;
+  delete fRotateCmd;
+  delete fSourceDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{ 
+  if( command == fModeCmd )
+  {
+    if (newValue == "native") fPrimary->SetMode(kSourceNative);
+    else if (newValue == "phasespace") fPrimary->SetMode(kSourcePhaseSpace);
+    else fPrimary->SetMode(kSourceGPS);
+  }
+  if( command == fParticleCmd )
+  {
+    fPrimary->SetParticle(newValue);
+  }
+  if( command == fPositionCmd )
+  {
+    fPrimary->SetPosition(fPositionCmd->GetNew3VectorValue(newValue));
+  }
+  if( command == fDirectionCmd )
+  {
+    fPrimary->SetDirection(fDirectionCmd->GetNew3VectorValue(newValue));
+  }
+  if( command == fEnergyCmd )
+  {
+    fPrimary->SetEnergy(fEnergyCmd->GetNewDoubleValue(newValue));
+  }
+  if( command == fSpectrumCmd )
+  {
+    G4String fileName, shape;
+    std::istringstream is(newValue);
+    is >> fileName >> shape;
+    fPrimary->LoadSpectrum(fileName, shape == "hist");
+  }
+  if( command == fPhaseSpaceCmd )
+  {
+    fPrimary->SetPhaseSpaceFiles(newValue);
+  }
+  if( command == fRecycleCmd )
+  {
+    fPrimary->SetRecycle(fRecycleCmd->GetNewIntValue(newValue));
+  }
+  if( command == fRotateCmd )
+  {
+    fPrimary->SetRotate(fRotateCmd->GetNewBoolValue(newValue));
+  }
+}
@@ -0,0 +1,64 @@
+/// \file ProcessIDTable.cc
+/// \brief Implementation of the ProcessIDTable class
+
+#include "ProcessIDTable.hh"
+
+#include "G4ProcessTable.hh"
+#include "G4ProcessVector.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ProcessIDTable::ProcessIDTable()
+: fRunID(-1)
+{
+  fNames.push_back("unknown");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ProcessIDTable* ProcessIDTable::Instance()
+{
+  static G4ThreadLocal ProcessIDTable* instance = 0;
+  if (!instance) instance = new ProcessIDTable;
+  return instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ProcessIDTable::~ProcessIDTable()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProcessIDTable::Build()
+{
+  G4ProcessTable* processTable = G4ProcessTable::GetProcessTable();
+
+  std::vector<G4String> names(*processTable->GetNameList());
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+  fNames.assign(1, "unknown");
+  fNames.insert(fNames.end(), names.begin(), names.end());
+
+  fIDs.clear();
+  G4ProcessVector* processes = processTable->FindProcesses();
+  for (std::size_t i = 0; i < processes->size(); ++i) {
+    const G4VProcess* process = (*processes)[i];
+    fIDs[process] = FindID(process->GetProcessName());
+  }
+  delete processes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int ProcessIDTable::FindID(const G4String& name) const
+{
+  auto it = std::lower_bound(fNames.begin() + 1, fNames.end(), name);
+  if (it == fNames.end() || *it != name) return 0;
+  return G4int(it - fNames.begin());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
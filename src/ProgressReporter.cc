@@ -0,0 +1,201 @@
+/// \file ProgressReporter.cc
+/// \brief Implementation of the ProgressReporter class
+
+#include "ProgressReporter.hh"
+#include "AsyncStepWriter.hh"
+#include "RunAction.hh"
+#include "SeedManager.hh"
+
+#include "G4Threading.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+  // Resident set size of the process, MB
+  G4double ResidentMB()
+  {
+    long pages = 0;
+    long resident = 0;
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm) return -1.;
+    G4int nRead = std::fscanf(statm, "%ld %ld", &pages, &resident);
+    std::fclose(statm);
+    if (nRead != 2) return -1.;
+    return resident * (sysconf(_SC_PAGESIZE) / 1048576.);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ProgressReporter* ProgressReporter::Instance()
+{
+  static ProgressReporter instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ProgressReporter::ProgressReporter()
+: fNSlots(1),
+  fInterval(30.),
+  fStatusFileSetting("auto"),
+  fRunID(-1),
+  fNEvents(0),
+  fStart(Clock::now()),
+  fNextReport(0.),
+  fLastReport(0.)
+{
+  for (G4int i = 0; i < kMaxSlots; ++i) {
+    fSlots[i].events = 0;
+    fSlots[i].steps = 0;
+    fSlots[i].records = 0;
+    fSlots[i].reportedEvents = 0;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ProgressReporter::~ProgressReporter()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressReporter::BeginRun(G4int runID, G4int nEvents,
+                                const G4String& outputFile)
+{
+  // Before the workers start their event loops
+  std::lock_guard<std::mutex> lock(fReportMutex);
+  for (G4int i = 0; i < kMaxSlots; ++i) {
+    fSlots[i].events = 0;
+    fSlots[i].steps = 0;
+    fSlots[i].records = 0;
+    fSlots[i].reportedEvents = 0;
+  }
+  fNSlots = 1;
+  fRunID = runID;
+  fNEvents = nEvents;
+  fStart = Clock::now();
+  fLastReport = 0.;
+  fNextReport = fInterval;
+
+  fStatusFile = fStatusFileSetting;
+  if (fStatusFile == "none") fStatusFile = "";
+  else if (fStatusFile == "auto") {
+    fStatusFile = RunAction::SideFileName(outputFile, ".status.json");
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressReporter::EventDone(G4long nSteps, G4long nRecords)
+{
+  G4int slot = std::max(G4Threading::G4GetThreadId(), 0) % kMaxSlots;
+  if (slot >= fNSlots) {
+    G4int nSlots = fNSlots;
+    while (nSlots <= slot && !fNSlots.compare_exchange_weak(nSlots, slot + 1)) {}
+  }
+  // Beyond kMaxSlots threads share a slot, so the counts are added
+  // atomically; uncontended, this costs no more than a load and a store
+  Slot& counters = fSlots[slot];
+  counters.events.fetch_add(1, std::memory_order_relaxed);
+  counters.steps.fetch_add(nSteps, std::memory_order_relaxed);
+  counters.records.fetch_add(nRecords, std::memory_order_relaxed);
+
+  if (fInterval <= 0.) return;
+  G4double now = Seconds(Clock::now());
+  G4double next = fNextReport.load(std::memory_order_relaxed);
+  if (now < next) return;
+  // One thread reports, the others carry on
+  if (!fNextReport.compare_exchange_strong(next, now + fInterval)) return;
+  Report("running");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressReporter::EndRun()
+{
+  if (fInterval <= 0. && fStatusFile.empty()) return;
+  Report("done");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProgressReporter::Report(const char* state)
+{
+  std::lock_guard<std::mutex> lock(fReportMutex);
+  G4double now = Seconds(Clock::now());
+  G4double sinceLast = now - fLastReport;
+  fLastReport = now;
+
+  G4long events = 0;
+  G4long steps = 0;
+  G4long records = 0;
+  G4long newEvents = 0;
+  std::ostringstream threadRates;
+  std::ostringstream threadJson;
+  G4int nSlots = fNSlots;
+  for (G4int i = 0; i < nSlots; ++i) {
+    Slot& slot = fSlots[i];
+    G4long slotEvents = slot.events.load(std::memory_order_relaxed);
+    G4double rate = sinceLast > 0. ? (slotEvents - slot.reportedEvents)/sinceLast : 0.;
+    newEvents += slotEvents - slot.reportedEvents;
+    slot.reportedEvents = slotEvents;
+    events += slotEvents;
+    steps += slot.steps.load(std::memory_order_relaxed);
+    records += slot.records.load(std::memory_order_relaxed);
+    threadRates << " " << i << ":" << G4long(rate + 0.5);
+    if (i > 0) threadJson << ", ";
+    threadJson << "{\"id\": " << i << ", \"events\": " << slotEvents
+               << ", \"eventsPerSecond\": " << rate << "}";
+  }
+
+  // ETA from the mean rate of the run, steadier than the last interval
+  G4double meanRate = now > 0. ? events/now : 0.;
+  G4double rate = sinceLast > 0. ? newEvents/sinceLast : 0.;
+  G4double stepRate = now > 0. ? steps/now : 0.;
+  G4double eta = (meanRate > 0. && fNEvents > events) ? (fNEvents - events)/meanRate : 0.;
+  G4double bytes = AsyncStepWriter::Instance()->GetBytesWritten();
+  G4double rss = ResidentMB();
+
+  if (fInterval > 0.) {
+    G4cout << "Progress run " << fRunID << ": " << events << "/" << fNEvents
+           << " events, " << rate << " events/s (mean " << meanRate << "), "
+           << stepRate << " steps/s, " << records << " records, "
+           << bytes/1048576. << " MB steps, RSS " << rss << " MB, ETA "
+           << G4long(eta) << " s" << G4endl
+           << "  events/s per thread:" << threadRates.str() << G4endl;
+  }
+  if (fStatusFile.empty()) return;
+
+  // Readers never see a partial file
+  G4String tmpFile = fStatusFile + ".tmp";
+  {
+    std::ofstream out(tmpFile.c_str());
+    if (!out) return;
+    out << "{\"state\": \"" << state << "\""
+        << ", \"seed\": " << SeedManager::GetBaseSeed()
+        << ", \"jobIndex\": " << SeedManager::GetJobIndex()
+        << ", \"numJobs\": " << SeedManager::GetNumJobs()
+        << ", \"runID\": " << fRunID
+        << ", \"updated\": " << long(std::time(0))
+        << ", \"elapsedSeconds\": " << now
+        << ", \"eventsDone\": " << events
+        << ", \"eventsTotal\": " << fNEvents
+        << ", \"eventsPerSecond\": " << rate
+        << ", \"meanEventsPerSecond\": " << meanRate
+        << ", \"stepsPerSecond\": " << stepRate
+        << ", \"records\": " << records
+        << ", \"bytesWritten\": " << bytes
+        << ", \"rssMB\": " << rss
+        << ", \"etaSeconds\": " << eta
+        << ", \"threads\": [" << threadJson.str() << "]}" << std::endl;
+  }
+  std::rename(tmpFile.c_str(), fStatusFile.c_str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,102 @@
+/// \file RecordSD.cc
+/// \brief Implementation of the RecordSD class
+
+#include "RecordSD.hh"
+#include "ProcessIDTable.hh"
+
+#include "G4HCofThisEvent.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4Run.hh"
+#include "G4RunManager.hh"
+#include "G4SDManager.hh"
+
+namespace {
+  const G4String kCollectionName = "steps";
+  // Column values, shared instead of built per hit
+  const G4String kTagNames[kNumRecordTags] = { "default", "Xe", "scintor" };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordSD::RecordSD(const G4String& name, G4int tag)
+ : G4VSensitiveDetector(name),
+   fHitsCollection(0),
+   fHCID(-1),
+   fTag(tag)
+{
+  collectionName.insert(kCollectionName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RecordSD::~RecordSD()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4String& RecordSD::GetCollectionName()
+{
+  return kCollectionName;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const G4String& RecordSD::GetTagName(G4int tag)
+{
+  return kTagNames[(tag >= 0 && tag < kNumRecordTags) ? tag : kTagDefault];
+}
+
+G4int RecordSD::FindTag(const G4String& name)
+{
+  for (G4int tag = 0; tag < kNumRecordTags; ++tag) {
+    if (kTagNames[tag] == name) return tag;
+  }
+  return kTagDefault;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RecordSD::Initialize(G4HCofThisEvent* hce)
+{
+  fHitsCollection = new StepHitsCollection(SensitiveDetectorName,
+                                           collectionName[0]);
+  if (fHCID < 0) {
+    fHCID = G4SDManager::GetSDMpointer()->GetCollectionID(fHitsCollection);
+  }
+  hce->AddHitsCollection(fHCID, fHitsCollection);
+
+  G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+  ProcessIDTable::Instance()->UpdateForRun(runID);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RecordSD::ProcessHits(G4Step* step, G4TouchableHistory*)
+{
+  const ProcessIDTable* processTable = ProcessIDTable::Instance();
+  const G4Track* track = step->GetTrack();
+  const G4StepPoint* preStepPoint = step->GetPreStepPoint();
+  const G4StepPoint* postStepPoint = step->GetPostStepPoint();
+
+  StepHit* hit = new StepHit();
+  hit->fParticle = track->GetDefinition();
+  hit->fPrePos = preStepPoint->GetPosition();
+  hit->fPostPos = postStepPoint->GetPosition();
+  hit->fEnergy = 1000 * preStepPoint->GetKineticEnergy();  // keV
+  hit->fEdep = 1000 * step->GetTotalEnergyDeposit();       // keV
+  hit->fTime = postStepPoint->GetGlobalTime();
+  hit->fWeight = preStepPoint->GetWeight();
+  hit->fTrackID = track->GetTrackID();
+  hit->fParentID = track->GetParentID();
+  hit->fCreatProcessID = processTable->GetID(preStepPoint->GetProcessDefinedStep());
+  hit->fEndProcessID = processTable->GetID(postStepPoint->GetProcessDefinedStep());
+  hit->fTag = fTag;
+  // The Xe target keeps the historical copyNo of -1
+  hit->fCopyNo = (fTag == kTagXe) ? -1 : preStepPoint->GetTouchable()->GetCopyNumber();
+  fHitsCollection->insert(hit);
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
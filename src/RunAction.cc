@@ -2,8 +2,17 @@
 /// \brief Implementation of the RunAction class
 
 #include "RunAction.hh"
+#include "RunMessenger.hh"
+#include "SeedManager.hh"
+#include "ProcessIDTable.hh"
+#include "RecordSD.hh"
+#include "AsyncStepWriter.hh"
+#include "StepRecord.hh"
 #include "PrimaryGeneratorAction.hh"
 #include "DetectorConstruction.hh"
+#include "StepProfiler.hh"
+#include "ProgressReporter.hh"
+#include "PhaseSpaceRecorder.hh"
 // #include "Run.hh"
 
 #include "G4Run.hh"
@@ -13,15 +22,44 @@
 #include "G4RunManager.hh"
 #include "G4Run.hh"
 #include "g4root.hh"
+#include "G4Threading.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <sys/stat.h>
 #include "G4AccumulableManager.hh"
 #include "G4LogicalVolumeStore.hh"
 #include "G4LogicalVolume.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
+namespace {
+  // Rows of the stepping profile, before the totals
+  const G4int kProfileRows = 30;
+  // Claimed by the first worker of a run that writes the dictionaries
+  std::atomic<G4bool> dictionariesClaimed(false);
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 //G4String m_hDataFilename;
 RunAction::RunAction()
+: G4UserRunAction(),
+  fMessenger(0),
+  fEncoding(kEncodeStrings),
+  fFormat(kFormatRoot),
+  fAccepted(0),
+  fRejected(0),
+  fAborted(0),
+  fSteps(0),
+  fOutputBytes(0.)
 { 
+  fMessenger = new RunMessenger(this);
+  G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
+  accumulableManager->RegisterAccumulable(fAccepted);
+  accumulableManager->RegisterAccumulable(fRejected);
+  accumulableManager->RegisterAccumulable(fAborted);
+  accumulableManager->RegisterAccumulable(fSteps);
+
   auto analysisManager = G4AnalysisManager::Instance();
  // G4AccumulableManager* analysisManager = G4AccumulableManager::Instance();
   analysisManager->SetVerboseLevel(1);
@@ -45,35 +83,291 @@ RunAction::RunAction()
   analysisManager->CreateNtupleSColumn("tag");
   analysisManager->CreateNtupleIColumn("copyNo"); //15
   analysisManager->CreateNtupleDColumn("time");
+  analysisManager->CreateNtupleDColumn("weight");   // statistical, see /Runmodel/bias/
+  analysisManager->FinishNtuple();
+
+  // One row per worker (or per sequential run) with what is needed to
+  // reproduce the shard
+  analysisManager->CreateNtuple("runinfo", "Seed and shard of the run");
+  analysisManager->CreateNtupleDColumn("seed");
+  analysisManager->CreateNtupleIColumn("jobIndex");
+  analysisManager->CreateNtupleIColumn("numJobs");
+  analysisManager->CreateNtupleIColumn("runID");
+  analysisManager->CreateNtupleIColumn("threadID");
+  analysisManager->CreateNtupleIColumn("nEvents");
+  analysisManager->CreateNtupleIColumn("nAccepted");  // coincidence trigger
+  analysisManager->CreateNtupleIColumn("nRejected");
+  analysisManager->CreateNtupleIColumn("firstEvent"); // of a checkpoint segment
+  analysisManager->FinishNtuple();
+
+  // Summed deposits per event and volume copy (hit mode, see /record/mode)
+  analysisManager->CreateNtuple("hits", "Energy deposits per event and volume");
+  analysisManager->CreateNtupleIColumn("eventID");
+  analysisManager->CreateNtupleSColumn("tag");
+  analysisManager->CreateNtupleIColumn("copyNo");
+  analysisManager->CreateNtupleIColumn("trackID");   // -1 when summed over tracks
+  analysisManager->CreateNtupleIColumn("pdg");
+  analysisManager->CreateNtupleDColumn("dE");        // keV
+  analysisManager->CreateNtupleDColumn("x");         // dE-weighted, mm
+  analysisManager->CreateNtupleDColumn("y");
+  analysisManager->CreateNtupleDColumn("z");
+  analysisManager->CreateNtupleDColumn("time");      // first deposit, ns
+  analysisManager->CreateNtupleIColumn("nSteps");
+  analysisManager->CreateNtupleDColumn("weight");    // dE-weighted mean
+  analysisManager->FinishNtuple();
+
+  // The "event" ntuple with integer codes instead of strings
+  // (/output/encoding code), decoded with the dictionaries below
+  analysisManager->CreateNtuple("event_code", "Energy and Position, coded");
+  analysisManager->CreateNtupleDColumn("Energy");
+  analysisManager->CreateNtupleFColumn("prex");
+  analysisManager->CreateNtupleFColumn("prey");
+  analysisManager->CreateNtupleFColumn("prez");
+  analysisManager->CreateNtupleFColumn("postx");
+  analysisManager->CreateNtupleFColumn("posty");    //5
+  analysisManager->CreateNtupleFColumn("postz");
+  analysisManager->CreateNtupleIColumn("pdg");
+  analysisManager->CreateNtupleIColumn("eventID");
+  analysisManager->CreateNtupleIColumn("trackID");
+  analysisManager->CreateNtupleIColumn("parentID");  //10
+  analysisManager->CreateNtupleDColumn("dE");
+  analysisManager->CreateNtupleIColumn("creatprosID");
+  analysisManager->CreateNtupleIColumn("endprosID");
+  analysisManager->CreateNtupleIColumn("tagID");
+  analysisManager->CreateNtupleIColumn("copyNo"); //15
+  analysisManager->CreateNtupleFColumn("time");
+  analysisManager->CreateNtupleDColumn("weight");
+  analysisManager->FinishNtuple();
+
+  analysisManager->CreateNtuple("processes", "Process ID dictionary");
+  analysisManager->CreateNtupleIColumn("id");
+  analysisManager->CreateNtupleSColumn("name");
+  analysisManager->FinishNtuple();
+
+  analysisManager->CreateNtuple("tags", "Volume tag dictionary");
+  analysisManager->CreateNtupleIColumn("id");
+  analysisManager->CreateNtupleSColumn("name");
   analysisManager->FinishNtuple();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::~RunAction()
-{}
+{
+  delete fMessenger;
+}
 
-void RunAction::BeginOfRunAction(const G4Run*)
+void RunAction::BeginOfRunAction(const G4Run* run)
 {
   G4RunManager::GetRunManager()->SetRandomNumberStore(false);
+  G4AccumulableManager::Instance()->Reset();
+  fOutputBytes = 0.;
+  StepProfiler::Instance()->Reset();
+  if (IsMaster()) {
+    ProgressReporter::Instance()->BeginRun(run->GetRunID(),
+                                           run->GetNumberOfEventToBeProcessed(),
+                                           m_hDataFilename);
+    PhaseSpaceRecorder::Instance()->Open(m_hDataFilename);
+    dictionariesClaimed = false;
+  }
   auto analysisManager = G4AnalysisManager::Instance();
 
+  // Only the ntuples of the chosen encoding are created in the file
+  G4bool coded = (fEncoding == kEncodeCodes);
+  G4bool rootSteps = (fFormat == kFormatRoot);
+  analysisManager->SetActivation(true);
+  analysisManager->SetNtupleActivation(kStepNtuple, rootSteps && !coded);
+  analysisManager->SetNtupleActivation(kStepCodeNtuple, rootSteps && coded);
+  analysisManager->SetNtupleActivation(kProcessDictNtuple, coded);
+  analysisManager->SetNtupleActivation(kTagDictNtuple, coded);
+
   G4String filename = m_hDataFilename;//"event.root";
   analysisManager->OpenFile(filename);
   G4cout << "Using " << analysisManager->GetType() << G4endl;
 
+  if (fFormat == kFormatBinary && IsMaster()) OpenStepFile(run);
+
 
 }
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void RunAction::EndOfRunAction(const G4Run* run)
 {
+  // Hand the last partial chunk of this thread to the writer; the master
+  // runs after all workers, so it can close the file
+  if (fFormat == kFormatBinary) {
+    AsyncStepWriter* writer = AsyncStepWriter::Instance();
+    if (IsMaster()) {
+      writer->Close();
+      fOutputBytes += writer->GetBytesWritten();
+      G4cout << " Step file: " << writer->GetBytesWritten() / 1048576.
+             << " MB written" << (writer->HasFailed() ? ", INCOMPLETE" : "")
+             << G4endl;
+    }
+    else {
+      writer->Flush();
+    }
+  }
+  PhaseSpaceRecorder* phaseSpace = PhaseSpaceRecorder::Instance();
+  if (phaseSpace->IsActive()) {
+    phaseSpace->Flush();
+    if (IsMaster()) phaseSpace->Close(run->GetNumberOfEvent());
+  }
+
   G4int nofEvents = run->GetNumberOfEvent();
   if (nofEvents == 0) return;
+  // Sums the worker trigger counters into the master's
+  G4AccumulableManager::Instance()->Merge();
   auto analysisManager = G4AnalysisManager::Instance();
+  if (!IsMaster() || !G4Threading::IsMultithreadedApplication()) {
+    analysisManager->FillNtupleDColumn(kRunInfoNtuple, 0,
+                                       SeedManager::GetBaseSeed());
+    analysisManager->FillNtupleIColumn(kRunInfoNtuple, 1,
+                                       SeedManager::GetJobIndex());
+    analysisManager->FillNtupleIColumn(kRunInfoNtuple, 2,
+                                       SeedManager::GetNumJobs());
+    analysisManager->FillNtupleIColumn(kRunInfoNtuple, 3,
+                                       SeedManager::GetRunID(run->GetRunID()));
+    analysisManager->FillNtupleIColumn(kRunInfoNtuple, 4,
+                                       G4Threading::G4GetThreadId());
+    analysisManager->FillNtupleIColumn(kRunInfoNtuple, 5, nofEvents);
+    analysisManager->FillNtupleIColumn(kRunInfoNtuple, 6, fAccepted.GetValue());
+    analysisManager->FillNtupleIColumn(kRunInfoNtuple, 7, fRejected.GetValue());
+    analysisManager->FillNtupleIColumn(kRunInfoNtuple, 8,
+                                       SeedManager::GetEventID(0));
+    analysisManager->AddNtupleRow(kRunInfoNtuple);
+  }
+  if (fEncoding == kEncodeCodes) FillDictionaries(run);
+  // Worker ntuples are merged into the master file on Write()
   analysisManager->Write();
   analysisManager->CloseFile();
+
+  // Worker ntuples are merged, the master file holds everything
+  if (IsMaster()) {
+    struct stat fileStatus;
+    if (stat(m_hDataFilename.c_str(), &fileStatus) == 0) {
+      fOutputBytes += fileStatus.st_size;
+    }
+  }
+
+  if (IsMaster()) {
+    G4cout << "--------------------End of Global Run-----------------------"
+           << G4endl << " The run consists of " << nofEvents << " events"
+           << G4endl;
+    if (fAccepted.GetValue() + fRejected.GetValue() > 0) {
+      G4cout << " Coincidence trigger: " << fAccepted.GetValue()
+             << " accepted, " << fRejected.GetValue() << " rejected ("
+             << fAborted.GetValue() << " aborted early)" << G4endl;
+    }
+  }
+
+  // Stepping profile (/stepping/profile): the workers hand in their
+  // tables, the master, which ends last, prints the sum
+  StepProfiler::Instance()->Merge();
+  if (IsMaster()) {
+    StepProfiler::Report(kProfileRows);
+    ProgressReporter::Instance()->EndRun();
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+
+void RunAction::FillDictionaries(const G4Run* run)
+{
+  // Written once per file: by the first worker to end the run with events
+  // (the others may have none), or by the sequential run. All threads
+  // number the processes alike, see ProcessIDTable.
+  if (G4Threading::IsMultithreadedApplication()) {
+    if (IsMaster() || dictionariesClaimed.exchange(true)) return;
+  }
+  auto analysisManager = G4AnalysisManager::Instance();
+
+  ProcessIDTable* processTable = ProcessIDTable::Instance();
+  processTable->UpdateForRun(run->GetRunID());
+  const std::vector<G4String>& names = processTable->GetNames();
+  for (std::size_t id = 0; id < names.size(); ++id) {
+    analysisManager->FillNtupleIColumn(kProcessDictNtuple, 0, G4int(id));
+    analysisManager->FillNtupleSColumn(kProcessDictNtuple, 1, names[id]);
+    analysisManager->AddNtupleRow(kProcessDictNtuple);
+  }
+  for (G4int tag = 0; tag < kNumRecordTags; ++tag) {
+    analysisManager->FillNtupleIColumn(kTagDictNtuple, 0, tag);
+    analysisManager->FillNtupleSColumn(kTagDictNtuple, 1,
+                                       RecordSD::GetTagName(tag));
+    analysisManager->AddNtupleRow(kTagDictNtuple);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String RunAction::SideFileName(const G4String& outputFile,
+                                 const G4String& suffix)
+{
+  G4String fileName = outputFile;
+  if (fileName.size() > 5 &&
+      fileName.compare(fileName.size() - 5, 5, ".root") == 0) {
+    fileName.erase(fileName.size() - 5);
+  }
+  return fileName + suffix;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::OpenStepFile(const G4Run* run)
+{
+  // Another run of this job to the same output file gets its own step file
+  G4String fileName = SideFileName(m_hDataFilename, ".steps");
+  AsyncStepWriter* writer = AsyncStepWriter::Instance();
+  if (writer->HasWritten(fileName)) {
+    fileName = SideFileName(m_hDataFilename, "_run" +
+      std::to_string(SeedManager::GetRunID(run->GetRunID())) + ".steps");
+  }
+
+  StepFileHeader header;
+  std::memcpy(header.magic, kStepFileMagic, sizeof(header.magic));
+  header.version = kStepFileVersion;
+  header.recordSize = sizeof(StepRecord);
+  header.seed = SeedManager::GetBaseSeed();
+  header.jobIndex = SeedManager::GetJobIndex();
+  header.numJobs = SeedManager::GetNumJobs();
+
+  // The event IDs this file holds, so that toyMerge can tell the parts
+  // of a checkpointed run from a shard written twice
+  StepFileSegment segment;
+  segment.runID = SeedManager::GetRunID(run->GetRunID());
+  segment.firstEvent = SeedManager::GetEventID(0);
+  segment.nEvents = run->GetNumberOfEventToBeProcessed();
+  segment.reserved = 0;
+
+  std::vector<char> bytes(sizeof(header) + sizeof(segment));
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  std::memcpy(bytes.data() + sizeof(header), &segment, sizeof(segment));
+  auto appendNames = [&bytes](const std::vector<G4String>& names) {
+    std::uint32_t count = std::uint32_t(names.size());
+    const char* countBytes = reinterpret_cast<const char*>(&count);
+    bytes.insert(bytes.end(), countBytes, countBytes + sizeof(count));
+    for (const auto& name : names) {
+      std::uint16_t length = std::uint16_t(name.size());
+      const char* lengthBytes = reinterpret_cast<const char*>(&length);
+      bytes.insert(bytes.end(), lengthBytes, lengthBytes + sizeof(length));
+      bytes.insert(bytes.end(), name.begin(), name.end());
+    }
+  };
+
+  // The master numbers the processes like the workers, see ProcessIDTable
+  ProcessIDTable* processTable = ProcessIDTable::Instance();
+  processTable->UpdateForRun(run->GetRunID());
+  appendNames(processTable->GetNames());
+  std::vector<G4String> tags;
+  for (G4int tag = 0; tag < kNumRecordTags; ++tag) {
+    tags.push_back(RecordSD::GetTagName(tag));
+  }
+  appendNames(tags);
+
+  G4int nProducers = G4Threading::GetNumberOfRunningWorkerThreads();
+  writer->Open(fileName, nProducers, bytes);
+  G4cout << "Writing steps to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,151 @@
+#include "RunMessenger.hh"
+#include "RunAction.hh"
+#include "ProgressReporter.hh"
+#include "PhaseSpaceRecorder.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunMessenger::RunMessenger(RunAction * runAction)
+:fRunAction(runAction)
+{ 
+  fOutputDir = new G4UIdirectory("/output/");
+  fOutputDir->SetGuidance("Output file layout.");
+
+  fEncodingCmd = new G4UIcmdWithAString("/output/encoding",this);
+  fEncodingCmd->SetGuidance("string : particle, process and tag names as strings");
+  fEncodingCmd->SetGuidance("         in the \"event\" ntuple");
+  fEncodingCmd->SetGuidance("code   : PDG code and integer IDs in \"event_code\",");
+  fEncodingCmd->SetGuidance("         decoded by the \"processes\" and \"tags\" ntuples");
+  fEncodingCmd->SetParameterName("encoding",false);
+  fEncodingCmd->SetCandidates("string code");
+  fEncodingCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fFormatCmd = new G4UIcmdWithAString("/output/format",this);
+  fFormatCmd->SetGuidance("root   : step rows in the ROOT file");
+  fFormatCmd->SetGuidance("binary : step rows in <outfile>.steps, written by a");
+  fFormatCmd->SetGuidance("         dedicated I/O thread (see StepRecord.hh);");
+  fFormatCmd->SetGuidance("         <outfile>_run<N>.steps when run N reuses the");
+  fFormatCmd->SetGuidance("         output file of an earlier run");
+  fFormatCmd->SetParameterName("format",false);
+  fFormatCmd->SetCandidates("root binary");
+  fFormatCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fFileNameCmd = new G4UIcmdWithAString("/output/fileName",this);
+  fFileNameCmd->SetGuidance("Output of the next runs, without extension, e.g. one");
+  fFileNameCmd->SetGuidance("file per /Runmodel/ModelChoose in a single job.");
+  fFileNameCmd->SetParameterName("fileName",false);
+  fFileNameCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fProgressIntervalCmd = new G4UIcmdWithADoubleAndUnit("/output/progressInterval",this);
+  fProgressIntervalCmd->SetGuidance("Time between two progress reports (events/s,");
+  fProgressIntervalCmd->SetGuidance("steps/s, records, RSS, ETA); 0 switches them off.");
+  fProgressIntervalCmd->SetParameterName("interval",false);
+  fProgressIntervalCmd->SetRange("interval>=0.");
+  fProgressIntervalCmd->SetUnitCategory("Time");
+  fProgressIntervalCmd->SetDefaultUnit("s");
+  fProgressIntervalCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fStatusFileCmd = new G4UIcmdWithAString("/output/statusFile",this);
+  fStatusFileCmd->SetGuidance("JSON file rewritten with every progress report and");
+  fStatusFileCmd->SetGuidance("at end of run. auto: <outfile>.status.json, none: off.");
+  fStatusFileCmd->SetParameterName("fileName",false);
+  fStatusFileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  // Shared by all threads, so only the master applies them
+  fPhaseSpaceCmd = new G4UIcmdWithAString("/output/phaseSpace",this);
+  fPhaseSpaceCmd->SetGuidance("Record the particles leaving the surface of");
+  fPhaseSpaceCmd->SetGuidance("/output/phaseSpaceSurface to this file and kill them");
+  fPhaseSpaceCmd->SetGuidance("there. auto: one <outfile>.phsp per run (checkpoint");
+  fPhaseSpaceCmd->SetGuidance("segments, scan points); none (the default): off.");
+  fPhaseSpaceCmd->SetGuidance("Recording runs never abort early (earlyAbort).");
+  fPhaseSpaceCmd->SetGuidance("Replayed with /source/mode phasespace.");
+  fPhaseSpaceCmd->SetParameterName("fileName",false);
+  fPhaseSpaceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fPhaseSpaceCmd->SetToBeBroadcasted(false);
+
+  fPhaseSpaceSurfaceCmd = new G4UIcommand("/output/phaseSpaceSurface",this);
+  fPhaseSpaceSurfaceCmd->SetGuidance("Recording surface: cylinder about the TPC axis");
+  fPhaseSpaceSurfaceCmd->SetGuidance("(default 13 26 9.02 cm: off the SS container wall");
+  fPhaseSpaceSurfaceCmd->SetGuidance("and end caps, the flanges reach through it).");
+  fPhaseSpaceSurfaceCmd->SetGuidance("It must enclose the source and stay inside whatever");
+  fPhaseSpaceSurfaceCmd->SetGuidance("changes between recording and replay.");
+  G4UIparameter* radiusParam = new G4UIparameter("radius",'d',false);
+  radiusParam->SetParameterRange("radius>0.");
+  fPhaseSpaceSurfaceCmd->SetParameter(radiusParam);
+  G4UIparameter* halfLengthParam = new G4UIparameter("halfLength",'d',false);
+  halfLengthParam->SetParameterRange("halfLength>0.");
+  fPhaseSpaceSurfaceCmd->SetParameter(halfLengthParam);
+  G4UIparameter* zCentreParam = new G4UIparameter("zCentre",'d',false);
+  fPhaseSpaceSurfaceCmd->SetParameter(zCentreParam);
+  G4UIparameter* unitParam = new G4UIparameter("unit",'s',true);
+  unitParam->SetDefaultValue("cm");
+  fPhaseSpaceSurfaceCmd->SetParameter(unitParam);
+  fPhaseSpaceSurfaceCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+  fPhaseSpaceSurfaceCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunMessenger::~RunMessenger()
+{
+  delete fEncodingCmd;
+  delete fFormatCmd;
+  delete fFileNameCmd;
+  delete fProgressIntervalCmd;
+  delete fStatusFileCmd;
+  delete fPhaseSpaceCmd;
+  delete fPhaseSpaceSurfaceCmd;
+  delete fOutputDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{ 
+  if( command == fEncodingCmd )
+  {
+    fRunAction->SetEncoding(newValue == "code" ? kEncodeCodes : kEncodeStrings);
+  }
+  if( command == fFormatCmd )
+  {
+    fRunAction->SetFormat(newValue == "binary" ? kFormatBinary : kFormatRoot);
+  }
+  if( command == fFileNameCmd )
+  {
+    // Same convention as the outfile argument of toyMC
+    fRunAction->SetDataFilenamemy(newValue + ".root");
+  }
+  // Shared by all threads, set from the master
+  if( command == fProgressIntervalCmd )
+  {
+    ProgressReporter::Instance()->SetInterval(
+      fProgressIntervalCmd->GetNewDoubleValue(newValue)/s);
+  }
+  if( command == fStatusFileCmd )
+  {
+    ProgressReporter::Instance()->SetStatusFile(newValue);
+  }
+  if( command == fPhaseSpaceCmd )
+  {
+    PhaseSpaceRecorder::Instance()->SetFileName(newValue);
+  }
+  if( command == fPhaseSpaceSurfaceCmd )
+  {
+    G4double radius, halfLength, zCentre;
+    G4String unit;
+    std::istringstream is(newValue);
+    is >> radius >> halfLength >> zCentre >> unit;
+    G4double value = G4UIcommand::ValueOf(unit);
+    PhaseSpaceRecorder::Instance()->SetSurface(radius*value, halfLength*value,
+                                               zCentre*value);
+  }
+}
@@ -0,0 +1,105 @@
+/// \file ScanDriver.cc
+/// \brief Implementation of the ScanDriver class
+
+#include "ScanDriver.hh"
+#include "ScanMessenger.hh"
+
+#include "G4UImanager.hh"
+#include "G4UIcommandStatus.hh"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+  std::string Trim(const std::string& text)
+  {
+    std::size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return std::string();
+    std::size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanDriver::ScanDriver()
+: fMessenger(0)
+{
+  fMessenger = new ScanMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanDriver::~ScanDriver()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScanDriver::Run(const G4String& scanFile, G4int nEvents,
+                     const G4String& outputBase)
+{
+  std::ifstream in(scanFile.c_str());
+  if (!in) {
+    G4ExceptionDescription description;
+    description << "Cannot open scan file " << scanFile;
+    G4Exception("ScanDriver::Run()", "Scan001", JustWarning, description);
+    return;
+  }
+
+  G4UImanager* uiManager = G4UImanager::GetUIpointer();
+  G4int nPoints = 0;
+  G4int nSkipped = 0;
+  std::string line;
+  while (std::getline(in, line)) {
+    line = Trim(line.substr(0, line.find('#')));
+    if (line.empty()) continue;
+
+    std::istringstream is(line);
+    std::string label;
+    std::string commands;
+    is >> label;
+    std::getline(is, commands);
+
+    if (!ApplyCommands(commands, "Scan point " + label)) {
+      G4cerr << "Scan point " << label << " skipped" << G4endl;
+      ++nSkipped;
+      continue;
+    }
+
+    G4cout << "==== Scan point " << label << " ====" << G4endl;
+    uiManager->ApplyCommand("/output/fileName " + outputBase + "_" + label);
+    std::ostringstream beamOn;
+    beamOn << "/run/beamOn " << nEvents;
+    uiManager->ApplyCommand(beamOn.str());
+    ++nPoints;
+  }
+  G4cout << "Scan " << scanFile << ": " << nPoints << " point(s) run, "
+         << nSkipped << " skipped" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ScanDriver::ApplyCommands(const G4String& commands,
+                                 const G4String& context)
+{
+  G4UImanager* uiManager = G4UImanager::GetUIpointer();
+  std::istringstream commandStream(commands);
+  std::string command;
+  while (std::getline(commandStream, command, ';')) {
+    command = Trim(command);
+    if (command.empty()) continue;
+    G4int status = uiManager->ApplyCommand(command);
+    if (status != fCommandSucceeded) {
+      G4cerr << context << ": \"" << command << "\" failed with status "
+             << status << G4endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
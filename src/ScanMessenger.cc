@@ -0,0 +1,53 @@
+#include "ScanMessenger.hh"
+#include "ScanDriver.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanMessenger::ScanMessenger(ScanDriver * scanDriver)
+:fScanDriver(scanDriver)
+{ 
+  fScanDir = new G4UIdirectory("/scan/");
+  fScanDir->SetGuidance("Parameter scans in one process.");
+
+  fRunCmd = new G4UIcommand("/scan/run",this);
+  fRunCmd->SetGuidance("Run every point of a scan file (label, then commands");
+  fRunCmd->SetGuidance("separated by ';'), writing <outputBase>_<label>.root.");
+  G4UIparameter* fileParam = new G4UIparameter("scanFile",'s',false);
+  fRunCmd->SetParameter(fileParam);
+  G4UIparameter* eventsParam = new G4UIparameter("nEvents",'i',false);
+  eventsParam->SetParameterRange("nEvents>0");
+  fRunCmd->SetParameter(eventsParam);
+  G4UIparameter* outputParam = new G4UIparameter("outputBase",'s',true);
+  outputParam->SetDefaultValue("scan");
+  fRunCmd->SetParameter(outputParam);
+  fRunCmd->AvailableForStates(G4State_Idle);
+  fRunCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScanMessenger::~ScanMessenger()
+{
+  delete fRunCmd;
+  delete fScanDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScanMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{ 
+  if( command == fRunCmd )
+  {
+    G4String scanFile, outputBase;
+    G4int nEvents = 0;
+    std::istringstream is(newValue);
+    is >> scanFile >> nEvents >> outputBase;
+    fScanDriver->Run(scanFile, nEvents, outputBase);
+  }
+}
@@ -0,0 +1,44 @@
+/// \file ScintorArrayParameterisation.cc
+/// \brief Implementation of the ScintorArrayParameterisation class
+
+#include "ScintorArrayParameterisation.hh"
+
+#include "G4VPhysicalVolume.hh"
+#include "G4ThreeVector.hh"
+#include "G4PhysicalConstants.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScintorArrayParameterisation::ScintorArrayParameterisation(G4int nPhi,
+                                                           G4int nLayers,
+                                                           G4double radius,
+                                                           G4double layerPitch)
+: G4VPVParameterisation(),
+  fNPhi(nPhi),
+  fNLayers(nLayers),
+  fRadius(radius),
+  fLayerPitch(layerPitch)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScintorArrayParameterisation::~ScintorArrayParameterisation()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScintorArrayParameterisation::ComputeTransformation(const G4int copyNo,
+                                                         G4VPhysicalVolume* physVol) const
+{
+  G4int layer = copyNo / fNPhi;
+  G4double phi = (copyNo % fNPhi) * twopi / fNPhi;
+  // Layers are symmetric about the envelope centre
+  G4double z = (layer - 0.5*(fNLayers - 1)) * fLayerPitch;
+  physVol->SetTranslation(G4ThreeVector(fRadius*std::cos(phi),
+                                        fRadius*std::sin(phi), z));
+  physVol->SetRotation(0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,59 @@
+/// \file SeedManager.cc
+/// \brief Implementation of the SeedManager class
+
+#include "SeedManager.hh"
+
+#include "Randomize.hh"
+#include "CLHEP/Random/MixMaxRng.h"
+
+long  SeedManager::fBaseSeed = 0;
+G4int SeedManager::fJobIndex = 0;
+G4int SeedManager::fNumJobs = 1;
+G4int SeedManager::fSegmentRunID = -1;
+G4int SeedManager::fSegmentFirstEvent = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SeedManager::Configure(long baseSeed, G4int jobIndex, G4int numJobs)
+{
+  fBaseSeed = baseSeed;
+  fJobIndex = jobIndex;
+  fNumJobs = numJobs;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SeedManager::SeedMaster()
+{
+  long seeds[2];
+  seeds[0] = fBaseSeed;
+  seeds[1] = fJobIndex;
+  G4Random::setTheEngine(new CLHEP::MixMaxRng);
+  G4Random::getTheEngine()->setSeeds(seeds, 2);
+  G4cout << "Initialize random numbers with seed = " << fBaseSeed
+         << ", job " << fJobIndex << " of " << fNumJobs << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SeedManager::SetSegment(G4int runID, G4int firstEvent)
+{
+  fSegmentRunID = runID;
+  fSegmentFirstEvent = firstEvent;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SeedManager::SeedEvent(G4int runID, G4int eventID)
+{
+  // One stream per (seed, job, run, event): MixMax maps the four words onto
+  // independent, non-overlapping sub-streams of its period
+  static G4ThreadLocal long seeds[4];
+  seeds[0] = GetEventID(eventID);
+  seeds[1] = GetRunID(runID);
+  seeds[2] = fJobIndex;
+  seeds[3] = fBaseSeed;
+  G4Random::getTheEngine()->setSeeds(seeds, 4);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,83 @@
+/// \file SplitOrKillOperation.cc
+/// \brief Implementation of the SplitOrKillOperation class
+
+#include "SplitOrKillOperation.hh"
+#include "ImportanceBiasingOperator.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4VPhysicalVolume.hh"
+#include "Randomize.hh"
+
+#include <cfloat>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SplitOrKillOperation::SplitOrKillOperation(
+  const G4String& name, const ImportanceBiasingOperator* biasingOperator)
+: G4VBiasingOperation(name),
+  fOperator(biasingOperator)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SplitOrKillOperation::~SplitOrKillOperation()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double SplitOrKillOperation::DistanceToApplyOperation(
+  const G4Track*, G4double, G4ForceCondition* condition)
+{
+  *condition = Forced;
+  return DBL_MAX;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VParticleChange* SplitOrKillOperation::GenerateBiasingFinalState(
+  const G4Track* track, const G4Step* step)
+{
+  fParticleChange.Initialize(*track);
+
+  const G4StepPoint* postStepPoint = step->GetPostStepPoint();
+  if (postStepPoint->GetStepStatus() != fGeomBoundary ||
+      !postStepPoint->GetPhysicalVolume()) return &fParticleChange;
+
+  G4double preImportance = fOperator->GetImportance(
+    step->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume());
+  G4double postImportance = fOperator->GetImportance(
+    postStepPoint->GetPhysicalVolume()->GetLogicalVolume());
+  if (postImportance == preImportance) return &fParticleChange;
+
+  G4double weight = track->GetWeight();
+  G4double ratio = postImportance / preImportance;
+  if (ratio > 1.) {
+    // Non-integer ratios split into floor(ratio) or floor(ratio) + 1
+    // copies, so that the expected number of copies is the ratio
+    G4int nCopies = G4int(ratio);
+    if (G4UniformRand() < ratio - nCopies) ++nCopies;
+    if (nCopies < 2) return &fParticleChange;
+
+    G4double copyWeight = weight / nCopies;
+    fParticleChange.ProposeParentWeight(copyWeight);
+    fParticleChange.SetSecondaryWeightByProcess(true);
+    fParticleChange.SetNumberOfSecondaries(nCopies - 1);
+    for (G4int i = 1; i < nCopies; ++i) {
+      G4Track* copy = new G4Track(new G4DynamicParticle(*track->GetDynamicParticle()),
+                                  track->GetGlobalTime(), track->GetPosition());
+      copy->SetWeight(copyWeight);
+      fParticleChange.AddSecondary(copy);
+    }
+  }
+  else if (G4UniformRand() < ratio) {
+    fParticleChange.ProposeParentWeight(weight / ratio);
+  }
+  else {
+    fParticleChange.ProposeTrackStatus(fStopAndKill);
+  }
+  return &fParticleChange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,102 @@
+/// \file StackingAction.cc
+/// \brief Implementation of the StackingAction class
+
+#include "StackingAction.hh"
+#include "EventAction.hh"
+#include "PhaseSpaceRecorder.hh"
+
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4Ions.hh"
+#include "G4Neutron.hh"
+#include "G4Positron.hh"
+#include "G4EventManager.hh"
+#include "G4Event.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::StackingAction(EventAction* eventAction)
+: G4UserStackingAction(),
+  fEventAction(eventAction),
+  fStage(0),
+  fPolicy(kAbortNever),
+  fPendingEnergy(0.),
+  fPendingUnbounded(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::~StackingAction()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::PrepareNewEvent()
+{
+  fStage = 0;
+  // An aborted event would lose the particles still to cross the
+  // phase-space surface, so recording never aborts
+  fPolicy = PhaseSpaceRecorder::Instance()->IsActive() ?
+            G4int(kAbortNever) : fEventAction->GetEarlyAbort();
+  fPendingEnergy = 0.;
+  fPendingUnbounded = false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack
+StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  PhaseSpaceRecorder* phaseSpace = PhaseSpaceRecorder::Instance();
+  if (phaseSpace->IsActive() && track->GetParentID() > 0 &&
+      !phaseSpace->IsInside(track->GetPosition())) return fKill;
+
+  if (fPolicy == kAbortNever || fStage > 0) return fUrgent;
+  if (track->GetParentID() == 0) return fUrgent;
+
+  // Neutrons can still be captured, unstable particles decay and excited
+  // nuclei de-excite, so their kinetic energy does not bound what they
+  // deposit; neutrinos deposit nothing
+  const G4ParticleDefinition* particle = track->GetDefinition();
+  const G4Ions* ion = dynamic_cast<const G4Ions*>(particle);
+  if (particle == G4Neutron::Definition() || !particle->GetPDGStable() ||
+      particle->GetPDGLifeTime() > 0. ||
+      (ion && ion->GetExcitationEnergy() > 0.)) {
+    fPendingUnbounded = true;
+  }
+  else if (particle->GetParticleType() != "lepton" ||
+           particle->GetPDGCharge() != 0.) {
+    fPendingEnergy += track->GetKineticEnergy();
+    if (particle == G4Positron::Definition()) {
+      fPendingEnergy += 2 * electron_mass_c2;
+    }
+  }
+  return fWaiting;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::NewStage()
+{
+  // Called once the primaries are done, with the waiting secondaries
+  // moved to the urgent stack
+  if (fStage++ > 0 || fPolicy == kAbortNever) return;
+
+  G4bool useless = false;
+  if (fPolicy == kAbortPrimary && !fEventAction->GetPrimaryInXe()) {
+    useless = true;
+  }
+  else if (!fPendingUnbounded) {
+    const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+    useless = !fEventAction->CanStillTrigger(event->GetHCofThisEvent(),
+                                             fPendingEnergy / keV);
+  }
+  if (useless) {
+    stackManager->clear();
+    fEventAction->SetAbortedEarly();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
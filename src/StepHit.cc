@@ -0,0 +1,29 @@
+/// \file StepHit.cc
+/// \brief Implementation of the StepHit class
+
+#include "StepHit.hh"
+
+G4ThreadLocal G4Allocator<StepHit>* StepHitAllocator = 0;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepHit::StepHit()
+ : G4VHit(),
+   fParticle(0),
+   fEnergy(0.),
+   fEdep(0.),
+   fTime(0.),
+   fTrackID(-1),
+   fParentID(-1),
+   fCreatProcessID(0),
+   fEndProcessID(0),
+   fTag(0),
+   fCopyNo(-1)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepHit::~StepHit()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,159 @@
+/// \file StepProfiler.cc
+/// \brief Implementation of the StepProfiler class
+
+#include "StepProfiler.hh"
+
+#include "G4Step.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <time.h>
+
+StepProfiler::MergedTable StepProfiler::fMerged;
+std::mutex StepProfiler::fMergeMutex;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepProfiler::StepProfiler()
+: fEnabled(false),
+  fLastTime(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepProfiler::~StepProfiler()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepProfiler* StepProfiler::Instance()
+{
+  static G4ThreadLocal StepProfiler* instance = 0;
+  if (!instance) instance = new StepProfiler;
+  return instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double StepProfiler::ThreadTime()
+{
+  timespec now;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+  return now.tv_sec + 1e-9*now.tv_nsec;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t StepProfiler::KeyHash::operator()(const Key& key) const
+{
+  std::hash<const void*> hash;
+  std::size_t seed = hash(key.volume);
+  seed ^= hash(key.particle) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  seed ^= hash(key.process) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  return seed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::CountStep(const G4Step* step)
+{
+  G4double now = ThreadTime();
+  const G4StepPoint* preStepPoint = step->GetPreStepPoint();
+  G4VPhysicalVolume* volume = preStepPoint->GetPhysicalVolume();
+  Key key = { volume ? volume->GetLogicalVolume() : 0,
+              step->GetTrack()->GetDefinition(),
+              step->GetPostStepPoint()->GetProcessDefinedStep() };
+  Entry& entry = fTable[key];
+  entry.steps += 1;
+  entry.seconds += now - fLastTime;
+  fLastTime = now;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::Merge()
+{
+  // Names are resolved here: the pointers of this run may not outlive it
+  std::lock_guard<std::mutex> lock(fMergeMutex);
+  for (const auto& item : fTable) {
+    std::vector<G4String> names(3);
+    names[0] = item.first.volume ? item.first.volume->GetName() : G4String("none");
+    names[1] = item.first.particle->GetParticleName();
+    names[2] = item.first.process ? item.first.process->GetProcessName()
+                                  : G4String("none");
+    Entry& merged = fMerged[names];
+    merged.steps += item.second.steps;
+    merged.seconds += item.second.seconds;
+  }
+  fTable.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::Report(G4int maxRows)
+{
+  std::lock_guard<std::mutex> lock(fMergeMutex);
+  if (fMerged.empty()) return;
+
+  typedef std::pair<G4String, Entry> Row;
+  G4long totalSteps = 0;
+  G4double totalSeconds = 0.;
+  std::vector<Row> rows;
+  std::map<G4String, Entry> totals[3];
+  for (const auto& item : fMerged) {
+    const std::vector<G4String>& names = item.first;
+    rows.push_back(Row(names[0] + " / " + names[1] + " / " + names[2],
+                       item.second));
+    for (G4int i = 0; i < 3; ++i) {
+      Entry& total = totals[i][names[i]];
+      total.steps += item.second.steps;
+      total.seconds += item.second.seconds;
+    }
+    totalSteps += item.second.steps;
+    totalSeconds += item.second.seconds;
+  }
+
+  auto printRows = [totalSeconds](std::vector<Row>& table, G4int nRows) {
+    std::sort(table.begin(), table.end(), [](const Row& a, const Row& b) {
+      return a.second.seconds > b.second.seconds;
+    });
+    G4int printed = 0;
+    for (const Row& row : table) {
+      if (nRows > 0 && printed++ == nRows) break;
+      G4cout << "  " << std::setw(12) << row.second.steps
+             << std::setw(12) << std::setprecision(4) << row.second.seconds
+             << std::setw(8) << std::setprecision(3)
+             << (totalSeconds > 0. ? 100.*row.second.seconds/totalSeconds : 0.)
+             << std::setw(10) << std::setprecision(3)
+             << 1e6*row.second.seconds/row.second.steps
+             << "  " << row.first << G4endl;
+    }
+  };
+  std::streamsize precision = G4cout.precision();
+
+  G4cout << "-------------------- Stepping profile --------------------" << G4endl
+         << " " << totalSteps << " steps, " << totalSeconds
+         << " s thread CPU time" << G4endl
+         << "         steps      time/s   time%   us/step  volume / particle / process"
+         << G4endl;
+  printRows(rows, maxRows);
+  if (maxRows > 0 && G4int(rows.size()) > maxRows) {
+    G4cout << "  ... " << rows.size() - maxRows << " more" << G4endl;
+  }
+  const char* titles[3] = { "volume", "particle", "process" };
+  for (G4int i = 0; i < 3; ++i) {
+    G4cout << " By " << titles[i] << ":" << G4endl;
+    std::vector<Row> table(totals[i].begin(), totals[i].end());
+    printRows(table, 0);
+  }
+  G4cout << "----------------------------------------------------------" << G4endl;
+  G4cout.precision(precision);
+  fMerged.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
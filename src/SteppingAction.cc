@@ -1,107 +1,98 @@
+
 #include "SteppingAction.hh"
+#include "SteppingMessenger.hh"
 #include "EventAction.hh"
-#include "DetectorConstruction.hh"
+#include "ProcessIDTable.hh"
+#include "RecordSD.hh"
+#include "StepProfiler.hh"
+#include "PhaseSpaceRecorder.hh"
+#include "SeedManager.hh"
 
 #include "G4Step.hh"
-#include "G4Event.hh"
+#include "G4Run.hh"
 #include "G4RunManager.hh"
-#include "G4LogicalVolume.hh"
 #include "G4EventManager.hh"
-#include "g4root.hh"
+#include "G4Event.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+
+namespace {
+  const G4int kXenonZ = 54;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SteppingAction::SteppingAction(EventAction* eventAction)
-: fEventAction(eventAction), fGammaCheck(false), fNGplan(false)  
-{}
+: fEventAction(eventAction), fScoringVolume(0),
+  fGammaCheck(false), fNGplan(false), fOutterSheildRecord(false),
+  fMessenger(0), fResolvedRunID(-1), fHadElasticID(0),
+  fKillXeRecoils(true),
+  fProfiler(StepProfiler::Instance()),
+  fPhaseSpace(PhaseSpaceRecorder::Instance())
+{
+  fMessenger = new SteppingMessenger(this);
+}
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 SteppingAction::~SteppingAction()
-{}
+{
+  delete fMessenger;
+}
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::SetProfile(G4bool flag)
+{
+  fProfiler->SetEnabled(flag);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void SteppingAction::UserSteppingAction(const G4Step* step)
 {
+    if (fProfiler->IsEnabled()) fProfiler->CountStep(step);
+    fEventAction->CountStep();
     G4Track* track = step->GetTrack();
-    G4String particleName = track->GetDefinition()->GetParticleName();
-    G4StepPoint* preStepPoint = step->GetPreStepPoint();
-    G4String processName = "unknown";
 
-    if (preStepPoint->GetProcessDefinedStep()) {
-        processName = preStepPoint->GetProcessDefinedStep()->GetProcessName();
-    }
-    G4int parentID = track->GetParentID();
-    
-    if (particleName.find("Xe") != std::string::npos) {
-        if (parentID > 0 && processName == "hadElastic") {
-            track->SetTrackStatus(fAlive);
-        } else if (track->GetCurrentStepNumber() > 1) {
+    if (fPhaseSpace->IsActive()) {
+        G4int eventID = SeedManager::GetEventID(G4EventManager::GetEventManager()
+          ->GetConstCurrentEvent()->GetEventID());
+        if (fPhaseSpace->RecordStep(step, eventID)) {
             track->SetTrackStatus(fStopAndKill);
+            return;
         }
     }
 
-    G4String volumeName = track->GetVolume()->GetName();
-    G4bool falg = (volumeName == "Xecylinder" || volumeName == "Scintor");
-    if (falg)
-    {
-        auto analysisManager = G4AnalysisManager::Instance();
-        G4float px = preStepPoint->GetPosition().x();
-        G4float py = preStepPoint->GetPosition().y();
-        G4float pz = preStepPoint->GetPosition().z();
-        G4float xp = step->GetPostStepPoint()->GetPosition().x();
-        G4float yp = step->GetPostStepPoint()->GetPosition().y();
-        G4float zp = step->GetPostStepPoint()->GetPosition().z();
-        G4float timeP = step->GetPostStepPoint()->GetGlobalTime();
-        
-        G4String endprosName = "unknown";
-        if (step->GetPostStepPoint()->GetProcessDefinedStep()) {
-            endprosName = step->GetPostStepPoint()->GetProcessDefinedStep()->GetProcessName();
-        }
-        
-        G4String creatprosName = "unknown";
-        if (preStepPoint->GetProcessDefinedStep()) {
-            creatprosName = preStepPoint->GetProcessDefinedStep()->GetProcessName();
-        }
-        
-        G4String tag; 
-        if (volumeName == "Xecylinder")
-            tag = "Xe"; 
-        else if (volumeName == "Scintor")
-            tag = "scintor";
-        else
-            tag = "default";
-        G4int copyNo = -1;
-        if (volumeName == "Scintor") {
-            copyNo = preStepPoint->GetTouchable()->GetCopyNumber();
-        }
+    // An interaction of a primary in the Xe target, for the early abort;
+    // volumes may carry detectors other than RecordSD
+    if (track->GetParentID() == 0 && !fEventAction->GetPrimaryInXe() &&
+        step->GetPostStepPoint()->GetStepStatus() == fPostStepDoItProc) {
+        auto sd = dynamic_cast<RecordSD*>(step->GetPreStepPoint()
+          ->GetTouchableHandle()->GetVolume()->GetLogicalVolume()
+          ->GetSensitiveDetector());
+        if (sd && sd->GetTag() == kTagXe) fEventAction->SetPrimaryInXe();
+    }
 
-        G4String particlename = particleName;
-        G4double energy = 1000 * preStepPoint->GetKineticEnergy();  // keV
-        G4double dE = 1000 * step->GetTotalEnergyDeposit();          // keV
-        G4int eventID = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
-        G4int trackID = track->GetTrackID();
-
-        analysisManager->FillNtupleDColumn(0, energy);
-        analysisManager->FillNtupleDColumn(1, px);
-        analysisManager->FillNtupleDColumn(2, py);
-        analysisManager->FillNtupleDColumn(3, pz);
-        analysisManager->FillNtupleDColumn(4, xp);
-        analysisManager->FillNtupleDColumn(5, yp);
-        analysisManager->FillNtupleDColumn(6, zp);
-        analysisManager->FillNtupleSColumn(7, particlename);
-        analysisManager->FillNtupleIColumn(8, eventID);
-        analysisManager->FillNtupleIColumn(9, trackID);
-        analysisManager->FillNtupleIColumn(10, parentID);
-        analysisManager->FillNtupleDColumn(11, dE);
-        analysisManager->FillNtupleSColumn(12, creatprosName);
-        analysisManager->FillNtupleSColumn(13, endprosName);
-        analysisManager->FillNtupleSColumn(14, tag);
-        analysisManager->FillNtupleIColumn(15, copyNo);
-        analysisManager->FillNtupleDColumn(16, timeP);  
-        analysisManager->AddNtupleRow();
+    if (!fKillXeRecoils) return;
+    // Xe recoils are only followed when they come from an elastic scatter
+    if (track->GetDefinition()->GetAtomicNumber() != kXenonZ) return;
+
+    ProcessIDTable* processTable = ProcessIDTable::Instance();
+    G4int runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+    if (runID != fResolvedRunID) {
+        processTable->UpdateForRun(runID);
+        fHadElasticID = processTable->FindID("hadElastic");
+        fResolvedRunID = runID;
     }
 
+    G4int processID =
+      processTable->GetID(step->GetPreStepPoint()->GetProcessDefinedStep());
+    if (track->GetParentID() > 0 && processID == fHadElasticID) {
+        track->SetTrackStatus(fAlive);
+    } else if (track->GetCurrentStepNumber() > 1) {
+        track->SetTrackStatus(fStopAndKill);
+    }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-
@@ -0,0 +1,51 @@
+#include "SteppingMessenger.hh"
+#include "SteppingAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SteppingMessenger::SteppingMessenger(SteppingAction * stepping)
+:fStepping(stepping)
+{ 
+  fSteppingDir = new G4UIdirectory("/stepping/");
+  fSteppingDir->SetGuidance("Track cuts applied by the stepping action.");
+
+  fKillXeCmd = new G4UIcmdWithABool("/stepping/killXeRecoils",this);
+  fKillXeCmd->SetGuidance("Kill Xe ions not produced by elastic scattering.");
+  fKillXeCmd->SetParameterName("flag",true);
+  fKillXeCmd->SetDefaultValue(true);
+  fKillXeCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+
+  fProfileCmd = new G4UIcmdWithABool("/stepping/profile",this);
+  fProfileCmd->SetGuidance("Charge the CPU time of every step to its volume,");
+  fProfileCmd->SetGuidance("particle and process, and print the table at end");
+  fProfileCmd->SetGuidance("of run. Costs a clock reading per step.");
+  fProfileCmd->SetParameterName("flag",true);
+  fProfileCmd->SetDefaultValue(true);
+  fProfileCmd->AvailableForStates(G4State_PreInit,G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SteppingMessenger::~SteppingMessenger()
+{
+  delete fKillXeCmd;
+  delete fProfileCmd;
+  delete fSteppingDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingMessenger::SetNewValue(G4UIcommand* command,G4String newValue)
+{ 
+  if( command == fKillXeCmd )
+  {
+    fStepping->SetKillXeRecoils(fKillXeCmd->GetNewBoolValue(newValue));
+  }
+  if( command == fProfileCmd )
+  {
+    fStepping->SetProfile(fProfileCmd->GetNewBoolValue(newValue));
+  }
+}
@@ -0,0 +1,26 @@
+/// \file TrackingAction.cc
+/// \brief Implementation of the TrackingAction class
+
+#include "TrackingAction.hh"
+#include "StepProfiler.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TrackingAction::TrackingAction()
+: G4UserTrackingAction(),
+  fProfiler(StepProfiler::Instance())
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TrackingAction::~TrackingAction()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrackingAction::PreUserTrackingAction(const G4Track*)
+{
+  if (fProfiler->IsEnabled()) fProfiler->StartTrack();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,74 @@
+/// \file CsvStepWriter.cc
+/// \brief Implementation of the CsvStepWriter class
+
+#include "CsvStepWriter.hh"
+
+namespace {
+  const char* kHeader =
+    "Energy,prex,prey,prez,postx,posty,postz,ptype,eventID,trackID,"
+    "parentID,dE,creatprosName,endprosName,tag,copyNo,time,step,weight\n";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CsvStepWriter::CsvStepWriter()
+ : fFile(0),
+   fRows(0),
+   fStep(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+CsvStepWriter::~CsvStepWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool CsvStepWriter::Open(const std::string& fileName)
+{
+  fFile = std::fopen(fileName.c_str(), "w");
+  if (!fFile) return false;
+  std::setvbuf(fFile, 0, _IOFBF, 1 << 20);
+  std::fputs(kHeader, fFile);
+  fRows = 0;
+  fStep = 0;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CsvStepWriter::Close()
+{
+  if (fFile) std::fclose(fFile);
+  fFile = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void CsvStepWriter::Write(const StepRow& row)
+{
+  bool sameTrack = fRows > 0 &&
+    row.eventID == fPrevious.eventID && row.trackID == fPrevious.trackID &&
+    row.ptype == fPrevious.ptype && row.tag == fPrevious.tag;
+  fStep = sameTrack ? fStep + 1 : 1;
+
+  std::fprintf(fFile,
+               "%.10g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%s,%lld,%d,%d,%.10g,"
+               "%s,%s,%s,%d,%.9g,%lld,%.9g\n",
+               row.energy, row.pre[0], row.pre[1], row.pre[2],
+               row.post[0], row.post[1], row.post[2], row.ptype.c_str(),
+               row.eventID, row.trackID, row.parentID, row.dE,
+               row.creatProcess.c_str(), row.endProcess.c_str(),
+               row.tag.c_str(), row.copyNo, row.time, fStep, row.weight);
+
+  // Only the key columns are kept; assign reuses the string capacity
+  fPrevious.eventID = row.eventID;
+  fPrevious.trackID = row.trackID;
+  fPrevious.ptype = row.ptype;
+  fPrevious.tag = row.tag;
+  ++fRows;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,36 @@
+/// \file CsvStepWriter.hh
+/// \brief Definition of the CsvStepWriter class
+
+#ifndef CsvStepWriter_h
+#define CsvStepWriter_h 1
+
+#include "StepRow.hh"
+
+#include <cstdio>
+#include <string>
+
+/// Writes step rows as the CSV of convert_to_csv.py, including its "step"
+/// column: the step counter restarts at 1 whenever ptype, eventID, trackID
+/// or tag differs from the previous row. Computed on the fly, so the
+/// output can be streamed.
+
+class CsvStepWriter
+{
+  public:
+    CsvStepWriter();
+    ~CsvStepWriter();
+
+    bool Open(const std::string& fileName);
+    void Close();
+    void Write(const StepRow& row);
+
+    long long GetRowsWritten() const { return fRows; }
+
+  private:
+    std::FILE* fFile;
+    StepRow fPrevious;
+    long long fRows;
+    long long fStep;
+};
+
+#endif
@@ -0,0 +1,359 @@
+/// \file StepReader.cc
+/// \brief Implementation of the StepReader classes
+
+#include "StepReader.hh"
+
+#include "g4root.hh"
+
+#include <cstring>
+
+namespace {
+  const char* kPositionNames[6] = { "prex", "prey", "prez",
+                                    "postx", "posty", "postz" };
+
+  bool EndsWith(const std::string& name, const std::string& suffix)
+  {
+    return name.size() >= suffix.size() &&
+      name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+  }
+
+  // G4AnalysisReader reads no row at all once a column missing from the
+  // file is bound, so columns added later (weight, firstEvent) are probed
+  // with a second reader of the ntuple first. An empty ntuple reads as
+  // lacking the column, which makes no difference.
+  bool HasColumn(const std::string& ntupleName, const std::string& fileName,
+                 const std::string& column, bool integer)
+  {
+    static G4int intValue;
+    static G4double doubleValue;
+    auto analysisReader = G4AnalysisReader::Instance();
+    G4int ntupleId = analysisReader->GetNtuple(ntupleName, fileName);
+    if (ntupleId < 0) return false;
+    if (integer) analysisReader->SetNtupleIColumn(ntupleId, column, intValue);
+    else analysisReader->SetNtupleDColumn(ntupleId, column, doubleValue);
+    return analysisReader->GetNtupleRow(ntupleId);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepReader* StepReader::Open(const std::string& fileName)
+{
+  if (EndsWith(fileName, ".steps")) {
+    BinaryStepReader* reader = new BinaryStepReader;
+    if (reader->OpenFile(fileName)) return reader;
+    delete reader;
+    return 0;
+  }
+  RootStepReader* reader = new RootStepReader;
+  if (reader->OpenFile(fileName)) return reader;
+  delete reader;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BinaryStepReader::BinaryStepReader()
+ : fFile(0),
+   fOffset(0),
+   fEventID(0),
+   fStepsLeft(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BinaryStepReader::~BinaryStepReader()
+{
+  if (fFile) std::fclose(fFile);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool BinaryStepReader::OpenFile(const std::string& fileName)
+{
+  fFile = std::fopen(fileName.c_str(), "rb");
+  if (!fFile) {
+    G4cerr << "Cannot open " << fileName << G4endl;
+    return false;
+  }
+  if (std::fread(&fHeader, sizeof(fHeader), 1, fFile) != 1 ||
+      std::memcmp(fHeader.magic, kStepFileMagic, sizeof(fHeader.magic)) != 0 ||
+      fHeader.version < 1 || fHeader.version > kStepFileVersion ||
+      fHeader.recordSize != sizeof(StepRecord)) {
+    G4cerr << fileName << " is not a step file of version 1 to "
+           << kStepFileVersion << G4endl;
+    return false;
+  }
+  fStamp.valid = true;
+  fStamp.seed = fHeader.seed;
+  fStamp.jobIndex = fHeader.jobIndex;
+  fStamp.numJobs = fHeader.numJobs;
+  if (fHeader.version >= 3) {
+    StepFileSegment segment;
+    if (std::fread(&segment, sizeof(segment), 1, fFile) != 1) {
+      G4cerr << fileName << ": truncated header" << G4endl;
+      return false;
+    }
+    fStamp.runID = segment.runID;
+    fStamp.firstEvent = segment.firstEvent;
+    fStamp.nEvents = segment.nEvents;
+  }
+  return ReadNames(fProcessNames) && ReadNames(fTagNames);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool BinaryStepReader::ReadNames(std::vector<std::string>& names)
+{
+  std::uint32_t count = 0;
+  if (std::fread(&count, sizeof(count), 1, fFile) != 1) return false;
+  names.resize(count);
+  for (auto& name : names) {
+    std::uint16_t length = 0;
+    if (std::fread(&length, sizeof(length), 1, fFile) != 1) return false;
+    name.resize(length);
+    if (length && std::fread(&name[0], 1, length, fFile) != length) return false;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool BinaryStepReader::ReadFrame()
+{
+  std::uint32_t size = 0;
+  if (std::fread(&size, sizeof(size), 1, fFile) != 1) return false;
+  fFrame.resize(size);
+  if (std::fread(fFrame.data(), 1, size, fFile) != size) {
+    G4cerr << "Truncated step file, last frame dropped" << G4endl;
+    return false;
+  }
+  fOffset = 0;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::string& BinaryStepReader::Name(const std::vector<std::string>& names,
+                                          unsigned id) const
+{
+  return id < names.size() ? names[id] : names[0];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool BinaryStepReader::Next(StepRow& row)
+{
+  // Frames hold whole events: a new event header is read only when the
+  // previous event is exhausted, and a new frame only at a frame end
+  while (fStepsLeft == 0) {
+    if (fOffset >= fFrame.size() && !ReadFrame()) return false;
+    StepEventHeader header;
+    std::memcpy(&header, fFrame.data() + fOffset, sizeof(header));
+    fOffset += sizeof(header);
+    fEventID = header.eventID;
+    fStepsLeft = header.nSteps;
+  }
+
+  StepRecord record;
+  std::memcpy(&record, fFrame.data() + fOffset, sizeof(record));
+  fOffset += sizeof(record);
+  --fStepsLeft;
+
+  row.energy = record.energy;
+  for (int i = 0; i < 3; ++i) {
+    row.pre[i] = record.pre[i];
+    row.post[i] = record.post[i];
+  }
+  row.dE = record.dE;
+  row.time = record.time;
+  row.weight = (fHeader.version < 2) ? 1. : record.weight;
+  row.ptype = std::to_string(record.pdg);
+  row.creatProcess = Name(fProcessNames, record.creatProcessID);
+  row.endProcess = Name(fProcessNames, record.endProcessID);
+  row.tag = Name(fTagNames, record.tag);
+  row.eventID = fEventID;
+  row.trackID = record.trackID;
+  row.parentID = record.parentID;
+  row.copyNo = record.copyNo;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RootStepReader::RootStepReader()
+ : fNtupleId(-1),
+   fCoded(false),
+   fWeight(1.),
+   fUnknown("unknown")
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RootStepReader::~RootStepReader()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool RootStepReader::OpenFile(const std::string& fileName)
+{
+  auto analysisReader = G4AnalysisReader::Instance();
+  analysisReader->SetVerboseLevel(0);
+
+  fCoded = false;
+  std::string ntupleName = "event";
+  fNtupleId = analysisReader->GetNtuple(ntupleName, fileName);
+  if (fNtupleId < 0) {
+    fCoded = true;
+    ntupleName = "event_code";
+    fNtupleId = analysisReader->GetNtuple(ntupleName, fileName);
+  }
+  if (fNtupleId < 0) {
+    G4cerr << "No event or event_code ntuple in " << fileName << G4endl;
+    return false;
+  }
+
+  analysisReader->SetNtupleDColumn(fNtupleId, "Energy", fEnergy);
+  analysisReader->SetNtupleIColumn(fNtupleId, "eventID", fEventID);
+  analysisReader->SetNtupleIColumn(fNtupleId, "trackID", fTrackID);
+  analysisReader->SetNtupleIColumn(fNtupleId, "parentID", fParentID);
+  analysisReader->SetNtupleDColumn(fNtupleId, "dE", fDE);
+  analysisReader->SetNtupleIColumn(fNtupleId, "copyNo", fCopyNo);
+  // Outputs from before biasing have no weight column: all weights are 1
+  fWeight = 1.;
+  if (HasColumn(ntupleName, fileName, "weight", false)) {
+    analysisReader->SetNtupleDColumn(fNtupleId, "weight", fWeight);
+  }
+  if (fCoded) {
+    for (int i = 0; i < 6; ++i) {
+      analysisReader->SetNtupleFColumn(fNtupleId, kPositionNames[i], fPosF[i]);
+    }
+    analysisReader->SetNtupleFColumn(fNtupleId, "time", fTimeF);
+    analysisReader->SetNtupleIColumn(fNtupleId, "pdg", fPdg);
+    analysisReader->SetNtupleIColumn(fNtupleId, "creatprosID", fCreatID);
+    analysisReader->SetNtupleIColumn(fNtupleId, "endprosID", fEndID);
+    analysisReader->SetNtupleIColumn(fNtupleId, "tagID", fTagID);
+    ReadDictionary("processes", fileName, fProcessNames);
+    ReadDictionary("tags", fileName, fTagNames);
+  }
+  else {
+    for (int i = 0; i < 6; ++i) {
+      analysisReader->SetNtupleDColumn(fNtupleId, kPositionNames[i], fPos[i]);
+    }
+    analysisReader->SetNtupleDColumn(fNtupleId, "time", fTime);
+    analysisReader->SetNtupleSColumn(fNtupleId, "ptype", fPtype);
+    analysisReader->SetNtupleSColumn(fNtupleId, "creatprosName", fCreat);
+    analysisReader->SetNtupleSColumn(fNtupleId, "endprosName", fEnd);
+    analysisReader->SetNtupleSColumn(fNtupleId, "tag", fTag);
+  }
+  ReadStamp(fileName);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RootStepReader::ReadStamp(const std::string& fileName)
+{
+  // Every row of runinfo (one per worker) carries the same seed, shard,
+  // run and first event; the events of the file are the sum over rows.
+  // Files without the firstEvent column hold whole runs, of an unknown
+  // number of events.
+  auto analysisReader = G4AnalysisReader::Instance();
+  G4bool hasFirstEvent = HasColumn("runinfo", fileName, "firstEvent", true);
+  G4int ntupleId = analysisReader->GetNtuple("runinfo", fileName);
+  if (ntupleId < 0) return;
+
+  G4double seed = 0.;
+  G4int jobIndex = 0, numJobs = 0, runID = 0, nEvents = 0, firstEvent = 0;
+  analysisReader->SetNtupleDColumn(ntupleId, "seed", seed);
+  analysisReader->SetNtupleIColumn(ntupleId, "jobIndex", jobIndex);
+  analysisReader->SetNtupleIColumn(ntupleId, "numJobs", numJobs);
+  analysisReader->SetNtupleIColumn(ntupleId, "runID", runID);
+  analysisReader->SetNtupleIColumn(ntupleId, "nEvents", nEvents);
+  if (hasFirstEvent) {
+    analysisReader->SetNtupleIColumn(ntupleId, "firstEvent", firstEvent);
+  }
+  long long totalEvents = 0;
+  while (analysisReader->GetNtupleRow(ntupleId)) {
+    if (!fStamp.valid) {
+      fStamp.valid = true;
+      fStamp.seed = (long long)seed;
+      fStamp.jobIndex = jobIndex;
+      fStamp.numJobs = numJobs;
+      fStamp.runID = runID;
+      fStamp.firstEvent = firstEvent;
+    }
+    totalEvents += nEvents;
+  }
+  if (fStamp.valid && hasFirstEvent) fStamp.nEvents = totalEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RootStepReader::ReadDictionary(const std::string& ntupleName,
+                                    const std::string& fileName,
+                                    std::vector<std::string>& names)
+{
+  auto analysisReader = G4AnalysisReader::Instance();
+  names.clear();
+  G4int ntupleId = analysisReader->GetNtuple(ntupleName, fileName);
+  if (ntupleId < 0) return;
+
+  G4int id = 0;
+  G4String name;
+  analysisReader->SetNtupleIColumn(ntupleId, "id", id);
+  analysisReader->SetNtupleSColumn(ntupleId, "name", name);
+  while (analysisReader->GetNtupleRow(ntupleId)) {
+    if (id < 0) continue;
+    if (std::size_t(id) >= names.size()) names.resize(id + 1, fUnknown);
+    names[id] = name;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::string& RootStepReader::Name(const std::vector<std::string>& names,
+                                        int id) const
+{
+  return (id >= 0 && std::size_t(id) < names.size()) ? names[id] : fUnknown;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool RootStepReader::Next(StepRow& row)
+{
+  if (!G4AnalysisReader::Instance()->GetNtupleRow(fNtupleId)) return false;
+
+  row.energy = fEnergy;
+  row.dE = fDE;
+  row.weight = fWeight;
+  row.eventID = fEventID;
+  row.trackID = fTrackID;
+  row.parentID = fParentID;
+  row.copyNo = fCopyNo;
+  if (fCoded) {
+    for (int i = 0; i < 3; ++i) {
+      row.pre[i] = fPosF[i];
+      row.post[i] = fPosF[i + 3];
+    }
+    row.time = fTimeF;
+    row.ptype = std::to_string(fPdg);
+    row.creatProcess = Name(fProcessNames, fCreatID);
+    row.endProcess = Name(fProcessNames, fEndID);
+    row.tag = Name(fTagNames, fTagID);
+  }
+  else {
+    for (int i = 0; i < 3; ++i) {
+      row.pre[i] = fPos[i];
+      row.post[i] = fPos[i + 3];
+    }
+    row.time = fTime;
+    row.ptype = fPtype;
+    row.creatProcess = fCreat;
+    row.endProcess = fEnd;
+    row.tag = fTag;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
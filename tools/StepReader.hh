@@ -0,0 +1,119 @@
+/// \file StepReader.hh
+/// \brief Definition of the StepReader classes
+
+#ifndef StepReader_h
+#define StepReader_h 1
+
+#include "StepRow.hh"
+#include "StepRecord.hh"
+
+#include "globals.hh"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// Seed and shard a file was produced with, read from the runinfo ntuple
+/// or the step file header when the file carries them, and the event IDs
+/// it holds: firstEvent to firstEvent + nEvents - 1 of run runID (from the
+/// StepFileSegment or runinfo); nEvents < 0 when unknown (older files),
+/// which stands for all events
+struct ShardStamp {
+  bool valid;
+  long long seed;
+  int jobIndex;
+  int numJobs;
+  int runID;
+  long long firstEvent;
+  long long nEvents;
+};
+
+/// Streams the step rows of one toyMC output file, whatever its layout:
+/// ROOT "event" or "event_code" ntuple, or a binary ".steps" file.
+/// Only one row (or one binary frame) is held in memory at a time.
+
+class StepReader
+{
+  public:
+    StepReader()
+    {
+      fStamp.valid = false;
+      fStamp.runID = 0;
+      fStamp.firstEvent = 0;
+      fStamp.nEvents = -1;
+    }
+    virtual ~StepReader() {}
+
+    /// Reader for the file, chosen from its extension; 0 on failure
+    static StepReader* Open(const std::string& fileName);
+
+    /// Next row, false at the end of the file
+    virtual bool Next(StepRow& row) = 0;
+
+    const ShardStamp& GetStamp() const { return fStamp; }
+
+  protected:
+    ShardStamp fStamp;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class BinaryStepReader : public StepReader
+{
+  public:
+    BinaryStepReader();
+    virtual ~BinaryStepReader();
+
+    bool OpenFile(const std::string& fileName);
+    virtual bool Next(StepRow& row);
+
+  private:
+    bool ReadNames(std::vector<std::string>& names);
+    bool ReadFrame();
+    const std::string& Name(const std::vector<std::string>& names,
+                            unsigned id) const;
+
+    std::FILE* fFile;
+    StepFileHeader fHeader;
+    std::vector<std::string> fProcessNames;
+    std::vector<std::string> fTagNames;
+    std::vector<char> fFrame;
+    std::size_t fOffset;
+    int fEventID;
+    int fStepsLeft;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class RootStepReader : public StepReader
+{
+  public:
+    RootStepReader();
+    virtual ~RootStepReader();
+
+    bool OpenFile(const std::string& fileName);
+    virtual bool Next(StepRow& row);
+
+  private:
+    void ReadStamp(const std::string& fileName);
+    void ReadDictionary(const std::string& ntupleName,
+                        const std::string& fileName,
+                        std::vector<std::string>& names);
+    const std::string& Name(const std::vector<std::string>& names,
+                            int id) const;
+
+    G4int fNtupleId;
+    G4bool fCoded;
+    // Column buffers bound to the reader
+    G4double fEnergy, fDE, fWeight;
+    G4double fPos[6], fTime;
+    G4float fPosF[6], fTimeF;
+    G4int fEventID, fTrackID, fParentID, fCopyNo;
+    G4int fPdg, fCreatID, fEndID, fTagID;
+    G4String fPtype, fCreat, fEnd, fTag;
+    std::vector<std::string> fProcessNames;
+    std::vector<std::string> fTagNames;
+    std::string fUnknown;
+};
+
+#endif
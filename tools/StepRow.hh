@@ -0,0 +1,31 @@
+/// \file StepRow.hh
+/// \brief One row of the step table, as read back by the offline tools
+
+#ifndef StepRow_h
+#define StepRow_h 1
+
+#include <string>
+
+/// Columns of the "event" ntuple. Readers fill the same object row after
+/// row, so the strings keep their capacity and reading does not allocate.
+/// Coded inputs (event_code ntuple, binary steps) give the PDG code as
+/// ptype, like convert_to_csv.py.
+
+struct StepRow {
+  double energy;
+  double pre[3];
+  double post[3];
+  double dE;
+  double time;
+  double weight;
+  std::string ptype;
+  std::string creatProcess;
+  std::string endProcess;
+  std::string tag;
+  long long eventID;
+  int trackID;
+  int parentID;
+  int copyNo;
+};
+
+#endif
@@ -0,0 +1,45 @@
+/// \file toyConvert.cc
+/// \brief Streams a toyMC output file to CSV (replaces convert_to_csv.py)
+
+#include "StepReader.hh"
+#include "CsvStepWriter.hh"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc,char** argv)
+{
+  std::string inputFile, outputFile;
+  for ( int i = 1; i < argc; ++i ) {
+    std::string arg = argv[i];
+    if ( arg == "--InputFile" && i + 1 < argc ) inputFile = argv[++i];
+    else if ( arg == "--OutputFile" && i + 1 < argc ) outputFile = argv[++i];
+  }
+  if ( inputFile.empty() || outputFile.empty() ) {
+    std::cerr << " Usage: toyConvert --InputFile out.root|out.steps"
+              << " --OutputFile out.csv" << std::endl;
+    return 1;
+  }
+
+  StepReader* reader = StepReader::Open(inputFile);
+  if ( ! reader ) return 1;
+  CsvStepWriter writer;
+  if ( ! writer.Open(outputFile) ) {
+    std::cerr << "Cannot open " << outputFile << std::endl;
+    delete reader;
+    return 1;
+  }
+
+  // One row in memory at a time
+  StepRow row;
+  while ( reader->Next(row) ) writer.Write(row);
+  writer.Close();
+  delete reader;
+
+  std::cout << inputFile << " -> " << outputFile << ": "
+            << writer.GetRowsWritten() << " rows" << std::endl;
+  return 0;
+}
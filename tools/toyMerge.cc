@@ -0,0 +1,157 @@
+/// \file toyMerge.cc
+/// \brief Streams sharded toyMC outputs into one CSV (replaces merge.py)
+
+#include "StepReader.hh"
+#include "CsvStepWriter.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+  struct Shard {
+    std::string fileName;
+    StepReader* reader;
+    long long offsetIndex;
+  };
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc,char** argv)
+{
+  std::string outputFile;
+  long long stride = 100000000LL;
+  std::vector<std::string> inputFiles;
+  for ( int i = 1; i < argc; ++i ) {
+    std::string arg = argv[i];
+    if ( arg == "--OutputFile" && i + 1 < argc ) outputFile = argv[++i];
+    else if ( arg == "--event-stride" && i + 1 < argc ) {
+      stride = std::atoll(argv[++i]);
+    }
+    else inputFiles.push_back(arg);
+  }
+  if ( outputFile.empty() || inputFiles.empty() || stride <= 0 ) {
+    std::cerr << " Usage: toyMerge --OutputFile merge.csv"
+              << " [--event-stride N] shard1 [shard2 ...]" << std::endl
+              << "   eventID becomes jobIndex * N + eventID, N = 1e8 by"
+              << " default;" << std::endl
+              << "   shards of several seeds take one block of numJobs"
+              << " job indices per seed" << std::endl;
+    return 1;
+  }
+
+  // Open every shard first: only the headers/metadata are read here
+  std::vector<Shard> shards;
+  G4bool allStamped = true;
+  for ( const auto& fileName : inputFiles ) {
+    StepReader* reader = StepReader::Open(fileName);
+    if ( ! reader ) {
+      std::cerr << "Skipping " << fileName << std::endl;
+      continue;
+    }
+    Shard shard = { fileName, reader, 0 };
+    allStamped = allStamped && reader->GetStamp().valid;
+    shards.push_back(shard);
+  }
+  if ( shards.empty() ) return 1;
+
+  // Event IDs are offset by the (seed, job index) stamped in each shard:
+  // jobIndex when all shards share one seed, so the IDs do not depend on
+  // the order or the subset of the input files; with several seeds each
+  // seed gets its own block of numJobs offsets, in increasing seed order.
+  // Files of the same seed and job (the parts of a checkpointed run) must
+  // hold disjoint event IDs; a shard given twice overlaps itself. Without
+  // stamps (old outputs) the position on the command line is used.
+  if ( allStamped ) {
+    std::stable_sort(shards.begin(), shards.end(),
+                     [](const Shard& a, const Shard& b) {
+                       const ShardStamp& sa = a.reader->GetStamp();
+                       const ShardStamp& sb = b.reader->GetStamp();
+                       if ( sa.seed != sb.seed ) return sa.seed < sb.seed;
+                       if ( sa.jobIndex != sb.jobIndex ) {
+                         return sa.jobIndex < sb.jobIndex;
+                       }
+                       return sa.firstEvent < sb.firstEvent; });
+    long long numJobs = 1;
+    for ( const auto& shard : shards ) {
+      const ShardStamp& stamp = shard.reader->GetStamp();
+      numJobs = std::max(numJobs, (long long)std::max(stamp.numJobs,
+                                                      stamp.jobIndex + 1));
+    }
+    long long seedIndex = 0;
+    for ( std::size_t i = 0; i < shards.size(); ++i ) {
+      const ShardStamp& stamp = shards[i].reader->GetStamp();
+      if ( i > 0 && shards[i - 1].reader->GetStamp().seed != stamp.seed ) {
+        ++seedIndex;
+      }
+      shards[i].offsetIndex = seedIndex * numJobs + stamp.jobIndex;
+      if ( i == 0 ) continue;
+      const ShardStamp& previous = shards[i - 1].reader->GetStamp();
+      if ( previous.seed != stamp.seed || previous.jobIndex != stamp.jobIndex ) {
+        continue;
+      }
+      if ( previous.nEvents < 0 ||
+           previous.firstEvent + previous.nEvents > stamp.firstEvent ) {
+        std::cerr << shards[i].fileName << " (run " << stamp.runID
+                  << ", events from " << stamp.firstEvent << ") and "
+                  << shards[i - 1].fileName << " (run " << previous.runID
+                  << ", events from " << previous.firstEvent
+                  << ") overlap in seed " << stamp.seed << ", job "
+                  << stamp.jobIndex << ", refusing to double count"
+                  << std::endl;
+        return 1;
+      }
+    }
+    if ( seedIndex > 0 ) {
+      std::cerr << "Shards of " << seedIndex + 1 << " seeds: event IDs are"
+                << " offset by (seed rank * " << numJobs << " + jobIndex)"
+                << std::endl;
+    }
+    // Seed and job order for the output
+    std::stable_sort(shards.begin(), shards.end(),
+                     [](const Shard& a, const Shard& b) {
+                       return a.offsetIndex < b.offsetIndex; });
+  }
+  else {
+    std::cerr << "Some shards carry no seed/job stamp, offsetting event IDs"
+              << " by input order" << std::endl;
+    for ( std::size_t i = 0; i < shards.size(); ++i ) {
+      shards[i].offsetIndex = (long long)i;
+    }
+  }
+
+  CsvStepWriter writer;
+  if ( ! writer.Open(outputFile) ) {
+    std::cerr << "Cannot open " << outputFile << std::endl;
+    return 1;
+  }
+
+  // Shards cover disjoint event ID ranges, so concatenating them in job
+  // order is already a merge by event; one row in memory at a time
+  StepRow row;
+  for ( auto& shard : shards ) {
+    long long offset = shard.offsetIndex * stride;
+    long long rows = writer.GetRowsWritten();
+    while ( shard.reader->Next(row) ) {
+      if ( row.eventID >= stride ) {
+        std::cerr << shard.fileName << ": event " << row.eventID
+                  << " does not fit in --event-stride " << stride << std::endl;
+        return 1;
+      }
+      row.eventID += offset;
+      writer.Write(row);
+    }
+    std::cout << shard.fileName << ": " << writer.GetRowsWritten() - rows
+              << " rows, event offset " << offset << std::endl;
+    delete shard.reader;
+    shard.reader = 0;
+  }
+  writer.Close();
+
+  std::cout << "Merged " << shards.size() << " shards into " << outputFile
+            << ": " << writer.GetRowsWritten() << " rows" << std::endl;
+  return 0;
+}
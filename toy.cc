@@ -1,9 +1,18 @@
 #include "DetectorConstruction.hh"
 #include "ActionInitialization.hh"
 #include "PhysicsList.hh"
+#include "ScanDriver.hh"
+#include "CheckpointDriver.hh"
+#include "BenchDriver.hh"
+#include "SeedManager.hh"
 
 #ifdef G4MULTITHREADED
 #include "G4MTRunManager.hh"
+#include "G4Threading.hh"
+#include "G4Version.hh"
+#if G4VERSION_NUMBER >= 1070
+#include "G4TaskRunManager.hh"
+#endif
 #else
 #include "G4RunManager.hh"
 #endif
@@ -14,39 +23,191 @@
 #include "G4VisExecutive.hh"
 #include "G4UIExecutive.hh"
 #include <sys/time.h>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <vector>
 #include "Randomize.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+namespace {
+  void PrintUsage()
+  {
+    G4cerr << " Usage: toyMC [-t nThreads] [--tasking] [--seed s]"
+           << " [--job-index i --num-jobs n] [macro [outfile]]" << G4endl
+           << "        toyMC [-t nThreads] --bench metrics.json"
+           << " [--bench-events n]" << G4endl
+           << "   -t, --threads N : number of worker threads (0 = all cores),"
+           << " ignored in a sequential build" << G4endl
+           << "   --tasking       : use the tasking run manager instead of"
+           << " the pthread one" << G4endl
+           << "   --seed S        : base seed, 0 to 4294967295 (default: from"
+           << " the clock)" << G4endl
+           << "   --job-index I   : index of this shard, 0 <= I < num-jobs"
+           << G4endl
+           << "   --num-jobs N    : total number of shards" << G4endl
+           << "   --bench FILE    : run the fixed benchmark workloads and"
+           << " write their metrics (JSON) to FILE; seed 12345 by default"
+           << G4endl
+           << "   --bench-events N: events per benchmark workload"
+           << " (default 1000)" << G4endl;
+  }
+
+  // Whole decimal number, at least minValue; anything else is a usage error
+  G4bool ParseInt(const G4String& option, const char* text, G4int minValue,
+                  G4int& value)
+  {
+    char* end = 0;
+    errno = 0;
+    long number = std::strtol(text, &end, 10);
+    if ( *end != '\0' || end == text || errno == ERANGE ||
+         number < minValue || number > INT_MAX ) {
+      G4cerr << "Invalid value " << text << " for " << option << G4endl;
+      PrintUsage();
+      return false;
+    }
+    value = G4int(number);
+    return true;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 int main(int argc,char** argv)
 {
-  // Detect interactive mode (if no arguments) and define UI session
+  // Times the startup when benchmarking, so it is created first
+  BenchDriver* benchDriver = 0;
+  for ( G4int i = 1; i < argc; ++i ) {
+    if ( G4String(argv[i]) == "--bench" ) benchDriver = new BenchDriver;
+  }
+
+  // Split options from the positional arguments (macro, outfile)
+  //
+  G4int nThreads = 1;
+  G4bool useTasking = false;
+  G4bool hasSeed = false;
+  long baseSeed = 0;
+  G4int jobIndex = 0;
+  G4int numJobs = 1;
+  G4String benchFile;
+  G4int benchEvents = 1000;
+  std::vector<G4String> args;
+  for ( G4int i = 1; i < argc; ++i ) {
+    G4String arg = argv[i];
+    G4bool takesValue = ( arg == "-t" || arg == "--threads" ||
+                          arg == "--seed" || arg == "--job-index" ||
+                          arg == "--num-jobs" || arg == "--bench" ||
+                          arg == "--bench-events" );
+    if ( takesValue && i + 1 >= argc ) {
+      PrintUsage();
+      return 1;
+    }
+    if ( arg == "-t" || arg == "--threads" ) {
+      if ( ! ParseInt(arg, argv[++i], 0, nThreads) ) return 1;
+    }
+    else if ( arg == "--seed" ) {
+      // Stamped and seeded as 32 bits, so other values are not reproducible
+      char* end = 0;
+      long long seed = std::strtoll(argv[++i], &end, 10);
+      if ( *end != '\0' || end == argv[i] || seed < 0 || seed > 0xFFFFFFFFLL ) {
+        G4cerr << "Invalid seed " << argv[i] << ": expected 0 to 4294967295"
+               << G4endl;
+        PrintUsage();
+        return 1;
+      }
+      baseSeed = long(seed);
+      hasSeed = true;
+    }
+    else if ( arg == "--job-index" ) {
+      if ( ! ParseInt(arg, argv[++i], 0, jobIndex) ) return 1;
+    }
+    else if ( arg == "--num-jobs" ) {
+      if ( ! ParseInt(arg, argv[++i], 1, numJobs) ) return 1;
+    }
+    else if ( arg == "--bench" ) {
+      benchFile = argv[++i];
+    }
+    else if ( arg == "--bench-events" ) {
+      if ( ! ParseInt(arg, argv[++i], 1, benchEvents) ) return 1;
+    }
+    else if ( arg == "--tasking" ) {
+      useTasking = true;
+    }
+    else if ( arg == "-h" || arg == "--help" ) {
+      PrintUsage();
+      return 0;
+    }
+    else {
+      args.push_back(arg);
+    }
+  }
+
+  if ( numJobs < 1 || jobIndex < 0 || jobIndex >= numJobs ) {
+    G4cerr << "Invalid shard: job index " << jobIndex << " of "
+           << numJobs << " jobs" << G4endl;
+    return 1;
+  }
+  if ( benchDriver && benchEvents < 1 ) {
+    G4cerr << "Invalid number of benchmark events " << benchEvents << G4endl;
+    return 1;
+  }
+
+  // Detect interactive mode (if no macro given) and define UI session
   //
   G4UIExecutive* ui = 0;
-  if ( argc == 1 ) {
+  if ( args.empty() && ! benchDriver ) {
     ui = new G4UIExecutive(argc, argv);
   }
-  struct timeval hTimeValue;
-  gettimeofday(&hTimeValue, NULL);
-  G4int m_hRanSeed = hTimeValue.tv_usec;
-  CLHEP::HepRandom::setTheEngine(new CLHEP::RanecuEngine);
-  G4cout << "Initialize random numbers with seed = "
-         << m_hRanSeed << G4endl;
-  CLHEP::HepRandom::setTheSeed(m_hRanSeed);
+  if ( ! hasSeed && benchDriver ) {
+    // Same events in every benchmark unless asked otherwise
+    baseSeed = 12345;
+  }
+  else if ( ! hasSeed ) {
+    // Not reproducible unless the stamped seed is passed back with --seed
+    struct timeval hTimeValue;
+    gettimeofday(&hTimeValue, NULL);
+    baseSeed = (hTimeValue.tv_sec ^ hTimeValue.tv_usec) & 0xFFFFFFFFL;
+  }
+  SeedManager::Configure(baseSeed, jobIndex, numJobs);
+  SeedManager::SeedMaster();
   auto actioninitial = new ActionInitialization();
   G4UImanager* UImanager = G4UImanager::GetUIpointer();
-  if ( (! ui) &&  (argc > 2) )
+  if ( (! ui) &&  (args.size() > 1) )
   {
-    //argv[2] is out file name
-    std::string outfile = argv[2];
+    //args[1] is out file name
+    std::string outfile = args[1];
     outfile = outfile + ".root";
     actioninitial->SetDataFilenamemy(outfile);
   }
   //actioninitial->SetDataFilenamemy("out.root");
+
+  // Construct the run manager: one process drives all worker threads,
+  // which share the geometry and the physics tables
+  //
+#ifdef G4MULTITHREADED
+  if ( nThreads <= 0 ) nThreads = G4Threading::G4GetNumberOfCores();
+  G4MTRunManager* runManager = 0;
+#if G4VERSION_NUMBER >= 1070
+  if ( useTasking ) runManager = new G4TaskRunManager;
+#endif
+  if ( ! runManager ) runManager = new G4MTRunManager;
+  runManager->SetNumberOfThreads(nThreads);
+  G4cout << "Running with " << nThreads << " worker thread(s)"
+         << ( useTasking ? " (tasking)" : "" ) << G4endl;
+#else
+  if ( nThreads > 1 || useTasking ) {
+    G4cout << "Geant4 built without multithreading,"
+           << " ignoring the thread options" << G4endl;
+  }
   G4RunManager* runManager = new G4RunManager;
+#endif
   
-  // Detector construction
-  runManager->SetUserInitialization(new DetectorConstruction());
+  // Detector construction; overlaps are only checked by default when
+  // the geometry is looked at, batch jobs opt in with /Runmodel/checkOverlaps
+  DetectorConstruction* detector = new DetectorConstruction();
+  detector->SetCheckOverlaps(ui != 0);
+  runManager->SetUserInitialization(detector);
   // Physics list
   //G4VModularPhysicsList* physicsList = new QBBC;
   //physicsList->SetVerboseLevel(1);
@@ -54,22 +215,33 @@ int main(int argc,char** argv)
   runManager->SetUserInitialization(new PhysicsList());
   // User action initialization
   runManager->SetUserInitialization(actioninitial);
-  // Initialize visualization
+  // Geometry scans within this process (/scan/run)
+  ScanDriver* scanDriver = new ScanDriver;
+  // Resumable runs (/checkpoint/beamOn, /checkpoint/resume)
+  CheckpointDriver* checkpointDriver = new CheckpointDriver;
+  // Initialize visualization, for interactive sessions only
   //
-  G4VisManager* visManager = new G4VisExecutive;
-  // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
-  // G4VisManager* visManager = new G4VisExecutive("Quiet");
-  visManager->Initialize();
+  G4VisManager* visManager = 0;
+  if ( ui ) {
+    visManager = new G4VisExecutive;
+    // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
+    // G4VisManager* visManager = new G4VisExecutive("Quiet");
+    visManager->Initialize();
+  }
 
   // Get the pointer to the User Interface manager
  
 
   // Process macro or start UI session
   //
-  if ( ! ui ) { 
+  G4int status = 0;
+  if ( benchDriver ) {
+    if ( ! benchDriver->Run(benchFile, benchEvents) ) status = 1;
+  }
+  else if ( ! ui ) { 
     // batch mode
     G4String command = "/control/execute ";
-    G4String fileName = argv[1];
+    G4String fileName = args[0];
     UImanager->ApplyCommand(command+fileName);
   }
   else { 
@@ -84,8 +256,12 @@ int main(int argc,char** argv)
   // owned and deleted by the run manager, so they should not be deleted 
   // in the main() program !
   
+  delete checkpointDriver;
+  delete scanDriver;
   delete visManager;
   delete runManager;
+  delete benchDriver;
+  return status;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo.....